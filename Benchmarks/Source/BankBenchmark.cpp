@@ -0,0 +1,156 @@
+/*
+  ==============================================================================
+
+    BankBenchmark.cpp
+    Created: 16 Oct 2026 10:00:00am
+    Author:  Olivier Doaré
+
+  ==============================================================================
+*/
+
+#include "Benchmarks.h"
+#include "../../Source/LorenzOsc.h"
+#include "../../Source/LorenzOscBank.h"
+
+namespace
+{
+    constexpr double settleSeconds = 0.5;
+    constexpr double measureSeconds = 2.0;
+    constexpr int controlInterval = 32;
+
+    // The voices play a chord on the preset's timestep, so the lanes need
+    // different numbers of sub-steps, as they do in the polyphonic mode
+    constexpr int chordSemitones[] = { 0, 4, 7, 12, 16, 19, 24, 28 };
+    constexpr float maxTimestep = 0.05f;
+
+    float getVoiceTimestep(const ParameterSnapshot& parameters, int voice)
+    {
+        return std::min(maxTimestep, parameters.timestep * std::pow(2.0f, (float) chordSemitones[voice] / 12.0f));
+    }
+
+    /** Voices one core renders in real time at the given cost. */
+    double getVoicesPerCore(double nanosecondsPerVoiceSample)
+    {
+        return 1.0e9 / (Benchmarks::sampleRate * nanosecondsPerVoiceSample);
+    }
+
+    /** Seconds to render numVoices scalar LorenzOscs, one after the other in each block. */
+    double timeScalarVoices(const ParameterSnapshot& parameters, int numVoices, int settleSamples, int measureSamples)
+    {
+        std::vector<std::unique_ptr<LorenzOsc>> voices;
+        for (int voice = 0; voice < numVoices; ++voice)
+        {
+            ParameterSnapshot voiceParameters = parameters;
+            voiceParameters.integrator = (int) LorenzOsc::Integrator::RK4;
+            voiceParameters.timestep = getVoiceTimestep(parameters, voice);
+
+            voices.push_back(std::make_unique<LorenzOsc>());
+            voices.back()->setControlInterval(controlInterval);
+            voices.back()->prepareToPlay(Benchmarks::sampleRate);
+            voices.back()->setParameters(voiceParameters);
+            voices.back()->reset();
+        }
+
+        std::vector<float> x ((size_t) Benchmarks::blockSize), y ((size_t) Benchmarks::blockSize), z ((size_t) Benchmarks::blockSize);
+        const auto renderAll = [&] (int numSamples)
+        {
+            for (int done = 0; done < numSamples; done += Benchmarks::blockSize)
+                for (auto& voice : voices)
+                    voice->renderBlock(x.data(), y.data(), z.data(), Benchmarks::blockSize);
+        };
+
+        renderAll(settleSamples);
+
+        const auto start = juce::Time::getHighResolutionTicks();
+        renderAll(measureSamples);
+        return Benchmarks::secondsSince(start);
+    }
+
+    /** Seconds to render NumLanes voices on one LorenzOscBank. */
+    template <int NumLanes>
+    double timeBank(const ParameterSnapshot& parameters, int settleSamples, int measureSamples)
+    {
+        auto bank = std::make_unique<LorenzOscBank<NumLanes>>();
+        bank->setControlInterval(controlInterval);
+        bank->prepareToPlay(Benchmarks::sampleRate);
+        bank->setParameters(parameters);
+
+        for (int lane = 0; lane < NumLanes; ++lane)
+        {
+            bank->setTimestep(lane, getVoiceTimestep(parameters, lane));
+            bank->setActive(lane, true);
+        }
+
+        bank->updateParameters();
+        for (int lane = 0; lane < NumLanes; ++lane)
+            bank->resetLane(lane);
+
+        std::vector<float> buffers[3 * NumLanes];
+        float* outputs[3][NumLanes];
+        for (int lane = 0; lane < NumLanes; ++lane)
+        {
+            for (int axis = 0; axis < 3; ++axis)
+            {
+                auto& buffer = buffers[axis * NumLanes + lane];
+                buffer.resize((size_t) Benchmarks::blockSize);
+                outputs[axis][lane] = buffer.data();
+            }
+        }
+
+        const auto renderAll = [&] (int numSamples)
+        {
+            for (int done = 0; done < numSamples; done += Benchmarks::blockSize)
+                bank->renderBlock(outputs[0], outputs[1], outputs[2], Benchmarks::blockSize);
+        };
+
+        renderAll(settleSamples);
+
+        const auto start = juce::Time::getHighResolutionTicks();
+        renderAll(measureSamples);
+        return Benchmarks::secondsSince(start);
+    }
+}
+
+namespace Benchmarks
+{
+    void runBankBenchmark(const std::vector<Preset>& presets)
+    {
+        std::printf("\n=== Lane-parallel RK4: LorenzOscBank against scalar LorenzOsc voices ===\n");
+        std::printf("%.0f Hz, %d-sample blocks, %.1f s per run after %.1f s of settling.\n",
+                    sampleRate, blockSize, measureSeconds, settleSeconds);
+        std::printf("The voices play a chord (0, 4, 7, 12... semitones) on the preset's timestep, so their\n");
+        std::printf("sub-step counts differ. Each bank is compared with as many scalar voices, on the same notes.\n");
+        std::printf("Voices one core renders in real time, and the bank's throughput against the scalar voices:\n\n");
+        std::printf("%-18s %-9s %9s %9s %6s %9s %9s %6s\n", "Preset", "dt", "4 scalar", "Bank<4>", "x", "8 scalar", "Bank<8>", "x");
+
+        const int settleSamples = juce::roundToInt(settleSeconds * sampleRate);
+        const int measureSamples = juce::roundToInt(measureSeconds * sampleRate);
+
+        double logSpeedupSums[2] {};
+
+        for (const auto& preset : presets)
+        {
+            ParameterSnapshot parameters = preset.parameters;
+            parameters.integrator = (int) LorenzOsc::Integrator::RK4;
+
+            const double voiceSamples4 = 4.0 * measureSamples;
+            const double voiceSamples8 = 8.0 * measureSamples;
+
+            // Nanoseconds per voice and per sample
+            const double scalar4 = 1.0e9 * timeScalarVoices(parameters, 4, settleSamples, measureSamples) / voiceSamples4;
+            const double bank4 = 1.0e9 * timeBank<4>(parameters, settleSamples, measureSamples) / voiceSamples4;
+            const double scalar8 = 1.0e9 * timeScalarVoices(parameters, 8, settleSamples, measureSamples) / voiceSamples8;
+            const double bank8 = 1.0e9 * timeBank<8>(parameters, settleSamples, measureSamples) / voiceSamples8;
+
+            logSpeedupSums[0] += std::log(scalar4 / bank4);
+            logSpeedupSums[1] += std::log(scalar8 / bank8);
+
+            std::printf("%-18s %-9.5f %9.0f %9.0f %6.2f %9.0f %9.0f %6.2f\n", preset.name.toRawUTF8(), parameters.timestep,
+                        getVoicesPerCore(scalar4), getVoicesPerCore(bank4), scalar4 / bank4,
+                        getVoicesPerCore(scalar8), getVoicesPerCore(bank8), scalar8 / bank8);
+        }
+
+        std::printf("\nGeometric mean of the throughput against as many scalar voices: Bank<4> %.2fx, Bank<8> %.2fx\n",
+                    std::exp(logSpeedupSums[0] / (double) presets.size()), std::exp(logSpeedupSums[1] / (double) presets.size()));
+    }
+}
@@ -0,0 +1,96 @@
+/*
+  ==============================================================================
+
+    BenchmarkPresets.cpp
+    Created: 16 Oct 2026 10:00:00am
+    Author:  Olivier Doaré
+
+  ==============================================================================
+*/
+
+#include "Benchmarks.h"
+#include "../../Source/FactoryPresets.h"
+
+namespace Benchmarks
+{
+    std::vector<Preset> loadFactoryPresets()
+    {
+        std::vector<Preset> presets;
+
+        for (const auto& factoryPreset : FactoryPresets::getAvailablePresets())
+        {
+            auto xml = juce::XmlDocument::parse(juce::String::fromUTF8(factoryPreset.data, factoryPreset.dataSize));
+            if (xml == nullptr)
+                continue;
+
+            // Parameters missing from a preset keep the snapshot's defaults
+            std::map<juce::String, double> values;
+            for (auto* param : xml->getChildWithTagNameIterator("PARAM"))
+                values[param->getStringAttribute("id")] = param->getDoubleAttribute("value");
+
+            const auto read = [&values] (const char* id, float fallback)
+            {
+                const auto it = values.find(id);
+                return it != values.end() ? static_cast<float>(it->second) : fallback;
+            };
+
+            Preset preset;
+            preset.name = factoryPreset.name;
+
+            auto& p = preset.parameters;
+            p.sigma = read("SIGMA", p.sigma);
+            p.rho = read("RHO", p.rho);
+            p.beta = read("BETA", p.beta);
+            p.mx = read("MX", p.mx);
+            p.my = read("MY", p.my);
+            p.mz = read("MZ", p.mz);
+            p.cx = read("CX", p.cx);
+            p.cy = read("CY", p.cy);
+            p.cz = read("CZ", p.cz);
+            p.taming = read("TAMING", p.taming);
+            p.timestep = read("TIMESTEP", p.timestep);
+            p.targetFrequency = read("TARGET_FREQ", 220.0f);
+            p.kp = read("KP", p.kp);
+            p.ki = read("KI", p.ki);
+            p.kd = read("KD", p.kd);
+            p.pidInterval = read("PID_INTERVAL", p.pidInterval);
+            p.pitchSource = static_cast<int>(read("PITCH_SOURCE", 0.0f));
+
+            presets.push_back(preset);
+        }
+
+        std::sort(presets.begin(), presets.end(), [] (const Preset& a, const Preset& b) { return a.name < b.name; });
+        return presets;
+    }
+
+    double measureCrossingFrequency(const std::vector<float>& signal, float level, float hysteresis, double signalSampleRate)
+    {
+        double firstCrossing = -1.0, lastCrossing = -1.0;
+        int numCrossings = 0;
+        bool armed = false;
+
+        for (size_t i = 1; i < signal.size(); ++i)
+        {
+            if (signal[i] < level - hysteresis)
+                armed = true;
+
+            if (armed && signal[i - 1] < level && signal[i] >= level)
+            {
+                // Crossing time interpolated between the two samples
+                const double time = static_cast<double>(i - 1) + (level - signal[i - 1]) / (signal[i] - signal[i - 1]);
+
+                if (numCrossings == 0)
+                    firstCrossing = time;
+
+                lastCrossing = time;
+                ++numCrossings;
+                armed = false;
+            }
+        }
+
+        if (numCrossings < 2)
+            return 0.0;
+
+        return signalSampleRate * (numCrossings - 1) / (lastCrossing - firstCrossing);
+    }
+}
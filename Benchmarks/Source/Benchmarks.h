@@ -0,0 +1,60 @@
+/*
+  ==============================================================================
+
+    Benchmarks.h
+    Created: 16 Oct 2026 10:00:00am
+    Author:  Olivier Doaré
+
+  ==============================================================================
+*/
+
+#pragma once
+
+#include <JuceHeader.h>
+#include "../../Source/ParameterSnapshot.h"
+
+/**
+ * Offline benchmarks of the DSP building blocks, run on the factory presets.
+ *
+ * Each suite prints one table to stdout. Times are wall-clock times of the
+ * rendering alone, on the calling thread, so run the Release build on an
+ * otherwise idle machine.
+ */
+namespace Benchmarks
+{
+    /** A factory preset, as the processor's snapshot would hold it. */
+    struct Preset
+    {
+        juce::String name;
+        ParameterSnapshot parameters;
+    };
+
+    /** Reads every factory preset from the binary resources. */
+    std::vector<Preset> loadFactoryPresets();
+
+    constexpr double sampleRate = 48000.0;
+    constexpr int blockSize = 64;
+
+    /** Output scales of the X, Y and Z signals in the processor, to express errors in dBFS. */
+    constexpr float xScale = 0.025f;
+    constexpr float yScale = 0.025f;
+    constexpr float zScale = 0.0125f;
+
+    /** Seconds elapsed since the given high-resolution tick count. */
+    inline double secondsSince(juce::int64 startTicks)
+    {
+        return juce::Time::highResolutionTicksToSeconds(juce::Time::getHighResolutionTicks() - startTicks);
+    }
+
+    /**
+     * Mean frequency of the upward crossings of a level, with hysteresis, over
+     * the whole signal. 0 if it crosses fewer than twice.
+     */
+    double measureCrossingFrequency(const std::vector<float>& signal, float level, float hysteresis, double signalSampleRate);
+
+    void runIntegratorBenchmark(const std::vector<Preset>& presets);
+    void runSubstepBenchmark(const std::vector<Preset>& presets);
+    void runBankBenchmark(const std::vector<Preset>& presets);
+    void runPredictorBenchmark(const std::vector<Preset>& presets);
+    void runDetectorBenchmark(const std::vector<Preset>& presets);
+}
@@ -0,0 +1,248 @@
+/*
+  ==============================================================================
+
+    DetectorBenchmark.cpp
+    Created: 16 Oct 2026 10:00:00am
+    Author:  Olivier Doaré
+
+  ==============================================================================
+*/
+
+#include "Benchmarks.h"
+#include "../../Source/LorenzOsc.h"
+#include "../../Source/PitchDetector.h"
+#include "../../Source/FrequencyTracker.h"
+
+namespace
+{
+    // As in the processor, undecimated
+    constexpr int windowSize = 4096;
+    constexpr int hopSize = 1024;
+
+    constexpr double settleSeconds = 0.5;
+    constexpr double measureSeconds = 2.0;
+
+    // Test tones: a sine, and a band-limited sawtooth whose strong harmonics invite octave errors
+    constexpr float toneFrequencies[] = { 55.0f, 110.0f, 220.0f, 440.0f, 880.0f, 1760.0f };
+    constexpr int numSawtoothHarmonics = 8;
+    constexpr float noiseLevel = 0.03f; // About -30 dB under the tone
+
+    constexpr int numDetectors = 3;
+    const char* const detectorNames[numDetectors] = { "MPM", "YIN", "ZeroCrossing" };
+
+    /** What one detector made of a signal, hop by hop. */
+    struct Result
+    {
+        std::vector<float> estimates; // Trusted estimates only
+        int numWindows = 0;
+        double seconds = 0.0;         // Time spent in detect()
+
+        float getMedian()
+        {
+            if (estimates.empty())
+                return 0.0f;
+
+            const auto middle = estimates.begin() + (std::ptrdiff_t) (estimates.size() / 2);
+            std::nth_element(estimates.begin(), middle, estimates.end());
+            return *middle;
+        }
+
+        /** Interquartile range of the estimates, in cents. */
+        double getSpreadCents()
+        {
+            if (estimates.size() < 4)
+                return 0.0;
+
+            std::sort(estimates.begin(), estimates.end());
+            return 1200.0 * std::log2(estimates[estimates.size() * 3 / 4] / estimates[estimates.size() / 4]);
+        }
+
+        double getMicrosecondsPerWindow() const { return numWindows > 0 ? 1.0e6 * seconds / numWindows : 0.0; }
+        double getTrustedPercent() const { return numWindows > 0 ? 100.0 * (double) estimates.size() / numWindows : 0.0; }
+    };
+
+    /** Runs a detector over every hop of the signal, as the PitchAnalyser would. */
+    Result analyse(PitchDetector& detector, const std::vector<float>& signal)
+    {
+        Result result;
+
+        for (size_t start = 0; start + (size_t) windowSize <= signal.size(); start += (size_t) hopSize)
+        {
+            const auto ticks = juce::Time::getHighResolutionTicks();
+            const float frequency = detector.detect(signal.data() + start);
+            result.seconds += Benchmarks::secondsSince(ticks);
+            ++result.numWindows;
+
+            if (frequency > 0.0f && detector.getConfidence() >= FrequencyTracker::minConfidence)
+                result.estimates.push_back(frequency);
+        }
+
+        return result;
+    }
+
+    std::vector<float> makeTone(float frequency, bool sawtooth, juce::Random& random)
+    {
+        std::vector<float> tone ((size_t) juce::roundToInt(measureSeconds * Benchmarks::sampleRate));
+        const int numHarmonics = sawtooth ? numSawtoothHarmonics : 1;
+
+        for (size_t i = 0; i < tone.size(); ++i)
+        {
+            const double phase = juce::MathConstants<double>::twoPi * frequency * (double) i / Benchmarks::sampleRate;
+
+            double value = 0.0;
+            for (int harmonic = 1; harmonic <= numHarmonics; ++harmonic)
+                value += std::sin(harmonic * phase) / harmonic;
+
+            tone[i] = 0.5f * static_cast<float>(value) + noiseLevel * (2.0f * random.nextFloat() - 1.0f);
+        }
+
+        return tone;
+    }
+
+    /** The preset's pitch-source signal at its output scale, and the attractor's rate from its Z section. */
+    std::pair<std::vector<float>, double> renderPitchSource(const ParameterSnapshot& parameters)
+    {
+        LorenzOsc osc;
+        osc.prepareToPlay(Benchmarks::sampleRate);
+        osc.setParameters(parameters);
+        osc.reset();
+
+        // A section source is read as the signal on the same coordinate
+        static constexpr int coordinates[] = { 0, 1, 2, 2, 0, 1 };
+        static constexpr float scales[] = { Benchmarks::xScale, Benchmarks::yScale, Benchmarks::zScale };
+        const int coordinate = coordinates[juce::jlimit(0, 5, parameters.pitchSource)];
+
+        const int settleSamples = juce::roundToInt(settleSeconds * Benchmarks::sampleRate);
+        const int totalSamples = settleSamples + juce::roundToInt(measureSeconds * Benchmarks::sampleRate);
+
+        std::vector<float> buffers[3];
+        for (auto& buffer : buffers)
+            buffer.resize((size_t) Benchmarks::blockSize);
+
+        std::vector<float> source, z;
+
+        for (int done = 0; done < totalSamples; done += Benchmarks::blockSize)
+        {
+            osc.renderBlock(buffers[0].data(), buffers[1].data(), buffers[2].data(), Benchmarks::blockSize);
+            if (done < settleSamples)
+                continue;
+
+            for (const float value : buffers[(size_t) coordinate])
+                source.push_back(value * scales[coordinate]);
+
+            z.insert(z.end(), buffers[2].begin(), buffers[2].end());
+        }
+
+        // Section at the mean of Z, with a quarter of its deviation as hysteresis
+        double sum = 0.0, sumOfSquares = 0.0;
+        for (const float value : z)
+        {
+            sum += value;
+            sumOfSquares += (double) value * value;
+        }
+
+        const double mean = sum / (double) z.size();
+        const double deviation = std::sqrt(std::max(0.0, sumOfSquares / (double) z.size() - mean * mean));
+        const double rate = Benchmarks::measureCrossingFrequency(z, static_cast<float>(mean), static_cast<float>(0.25 * deviation),
+                                                                 Benchmarks::sampleRate);
+        return { source, rate };
+    }
+
+    void printCents(char (&text)[16], double frequency, double reference)
+    {
+        if (frequency > 0.0 && reference > 0.0)
+            std::snprintf(text, sizeof (text), "%+.1f", 1200.0 * std::log2(frequency / reference));
+        else
+            std::snprintf(text, sizeof (text), "-");
+    }
+}
+
+namespace Benchmarks
+{
+    void runDetectorBenchmark(const std::vector<Preset>& presets)
+    {
+        std::printf("\n=== Pitch detectors: cost and accuracy of MPM, YIN and zero crossing ===\n");
+        std::printf("%d-sample windows every %d samples at %.0f Hz, undecimated, over %.1f s.\n",
+                    windowSize, hopSize, sampleRate, measureSeconds);
+        std::printf("Only estimates with a confidence of at least %.1f are kept, as the pitch lock does.\n",
+                    FrequencyTracker::minConfidence);
+        std::printf("error: median estimate against the tone, in cents. hits: windows within 10 cents.\n\n");
+
+        std::array<std::unique_ptr<PitchDetector>, numDetectors> detectors;
+        for (int d = 0; d < numDetectors; ++d)
+        {
+            detectors[(size_t) d] = PitchDetector::create(static_cast<PitchDetector::Type>(d));
+            detectors[(size_t) d]->prepare(sampleRate, windowSize);
+        }
+
+        std::printf("%-10s %8s %-13s %10s %8s %8s\n", "Tone", "Hz", "Detector", "us/window", "error", "hits");
+
+        juce::Random random (1);
+        double toneSeconds[numDetectors] {};
+        int toneWindows[numDetectors] {}, toneHits[numDetectors] {};
+
+        for (const bool sawtooth : { false, true })
+        {
+            for (const float frequency : toneFrequencies)
+            {
+                const auto tone = makeTone(frequency, sawtooth, random);
+
+                for (int d = 0; d < numDetectors; ++d)
+                {
+                    auto result = analyse(*detectors[(size_t) d], tone);
+
+                    int hits = 0;
+                    for (const float estimate : result.estimates)
+                        hits += std::abs(1200.0 * std::log2(estimate / frequency)) <= 10.0 ? 1 : 0;
+
+                    toneSeconds[d] += result.seconds;
+                    toneWindows[d] += result.numWindows;
+                    toneHits[d] += hits;
+
+                    char error[16];
+                    printCents(error, result.getMedian(), frequency);
+
+                    std::printf("%-10s %8.1f %-13s %10.1f %8s %7.0f%%\n",
+                                d == 0 ? (sawtooth ? "Sawtooth" : "Sine") : "", frequency, detectorNames[d],
+                                result.getMicrosecondsPerWindow(), error, 100.0 * hits / std::max(1, result.numWindows));
+                }
+            }
+        }
+
+        std::printf("\nOn the attractors, at each preset's timestep. vs Z: median estimate against the rate of the\n");
+        std::printf("Z section crossings, in cents (-1200 is half the rate). spread: interquartile range, in cents.\n");
+        std::printf("trusted: windows with a confident estimate.\n\n");
+        std::printf("%-18s %-7s %-13s %10s %9s %8s %8s %8s\n", "Preset", "Source", "Detector", "us/window", "median Hz", "vs Z", "spread", "trusted");
+
+        static const char* const sourceNames[] = { "X", "Y", "Z", "Z", "X", "Y" };
+        double presetSeconds[numDetectors] {};
+        int presetWindows[numDetectors] {};
+
+        for (const auto& preset : presets)
+        {
+            const auto [source, rate] = renderPitchSource(preset.parameters);
+
+            for (int d = 0; d < numDetectors; ++d)
+            {
+                auto result = analyse(*detectors[(size_t) d], source);
+                presetSeconds[d] += result.seconds;
+                presetWindows[d] += result.numWindows;
+
+                const float median = result.getMedian();
+                char versusZ[16];
+                printCents(versusZ, median, rate);
+
+                std::printf("%-18s %-7s %-13s %10.1f %9.1f %8s %8.1f %7.0f%%\n",
+                            d == 0 ? preset.name.toRawUTF8() : "", sourceNames[juce::jlimit(0, 5, preset.parameters.pitchSource)],
+                            detectorNames[d], result.getMicrosecondsPerWindow(), median, versusZ,
+                            result.getSpreadCents(), result.getTrustedPercent());
+            }
+        }
+
+        std::printf("\nOverall:\n");
+        for (int d = 0; d < numDetectors; ++d)
+            std::printf("  %-13s %8.1f us/window, %5.1f %% of the test-tone windows within 10 cents\n", detectorNames[d],
+                        1.0e6 * (toneSeconds[d] + presetSeconds[d]) / std::max(1, toneWindows[d] + presetWindows[d]),
+                        100.0 * toneHits[d] / std::max(1, toneWindows[d]));
+    }
+}
@@ -0,0 +1,274 @@
+/*
+  ==============================================================================
+
+    IntegratorBenchmark.cpp
+    Created: 16 Oct 2026 10:00:00am
+    Author:  Olivier Doaré
+
+  ==============================================================================
+*/
+
+#include "Benchmarks.h"
+#include "../../Source/LorenzOsc.h"
+
+namespace
+{
+    // The attractor first settles on its orbit, then the integrators are
+    // compared over a short horizon (before the chaos amplifies any difference)
+    // and over a long run (for the cost and the pitch).
+    constexpr double settleSeconds = 0.5;
+    constexpr double horizonSeconds = 0.002;
+    constexpr double measureSeconds = 2.0;
+
+    // The reference is RK4 with this many times shorter steps, at the same simulation time per sample
+    constexpr int referenceOversampling = 8;
+
+    constexpr int controlInterval = 32;
+
+    // Like the PID, the measured runs nudge the timestep every 10 ms, here by
+    // +/- 0.05 % around its value, so it ramps most of the time.
+    constexpr int pidIntervalSamples = 480;
+    constexpr float pidNudge = 0.0005f;
+
+    // Top of the TIMESTEP range, where RK4 needs the most sub-steps
+    constexpr float maxTimestep = 0.05f;
+
+    constexpr int numIntegrators = 3;
+    const char* const integratorNames[numIntegrators] = { "RK4", "Adaptive RK45", "Rosenbrock" };
+
+    // Timesteps of the sub-step sweep: RK4 takes 1, 2, 5 and 10 sub-steps per sample, Rosenbrock 1 or 2
+    constexpr float sweepTimesteps[] = { 0.005f, 0.01f, 0.025f, 0.05f };
+
+    void prepare(LorenzOsc& osc, const ParameterSnapshot& parameters, double sampleRate)
+    {
+        osc.setControlInterval(controlInterval);
+        osc.prepareToPlay(sampleRate);
+        osc.setParameters(parameters);
+        osc.reset();
+    }
+
+    /**
+     * Renders numSamples in blocks, keeping every step-th sample of X and Z.
+     * With a pidTimestep, the timestep is nudged around it at the PID rate.
+     */
+    void render(LorenzOsc& osc, int numSamples, int step, std::vector<float>& xOut, std::vector<float>& zOut,
+                float pidTimestep = 0.0f)
+    {
+        const int block = Benchmarks::blockSize * step;
+        std::vector<float> x ((size_t) block), y ((size_t) block), z ((size_t) block);
+
+        xOut.clear();
+        zOut.clear();
+
+        for (int done = 0; done < numSamples * step; done += block)
+        {
+            const int n = std::min(block, numSamples * step - done);
+
+            if (pidTimestep > 0.0f && (done / step) % pidIntervalSamples < Benchmarks::blockSize)
+                osc.setTimestep(pidTimestep * (((done / step) / pidIntervalSamples) % 2 == 0 ? 1.0f + pidNudge : 1.0f - pidNudge));
+
+            osc.renderBlock(x.data(), y.data(), z.data(), n);
+
+            for (int i = step - 1; i < n; i += step)
+            {
+                xOut.push_back(x[(size_t) i]);
+                zOut.push_back(z[(size_t) i]);
+            }
+        }
+    }
+
+    /** Renders the reference for the parameters: RK4 with referenceOversampling times shorter steps. */
+    LorenzKernels::State<double> renderReference(const ParameterSnapshot& parameters, int settleSamples, int horizonSamples, int measureSamples,
+                                                 std::vector<float>& referenceX, std::vector<float>& referenceZ)
+    {
+        ParameterSnapshot referenceParameters = parameters;
+        referenceParameters.integrator = 0;
+        referenceParameters.timestep = parameters.timestep / referenceOversampling;
+
+        LorenzOsc reference;
+        prepare(reference, referenceParameters, Benchmarks::sampleRate * referenceOversampling);
+
+        std::vector<float> unused;
+        render(reference, settleSamples, referenceOversampling, unused, unused);
+        const auto startState = reference.getState();
+        render(reference, horizonSamples, referenceOversampling, referenceX, unused);
+        render(reference, measureSamples, referenceOversampling, unused, referenceZ);
+        return startState;
+    }
+
+    /** Section level and hysteresis for the pitch: the mean of Z and a quarter of its deviation. */
+    std::pair<float, float> getSection(const std::vector<float>& z)
+    {
+        double sum = 0.0, sumOfSquares = 0.0;
+        for (const float value : z)
+        {
+            sum += value;
+            sumOfSquares += (double) value * value;
+        }
+
+        const double mean = sum / (double) z.size();
+        const double deviation = std::sqrt(std::max(0.0, sumOfSquares / (double) z.size() - mean * mean));
+        return { static_cast<float>(mean), static_cast<float>(0.25 * deviation) };
+    }
+}
+
+namespace Benchmarks
+{
+    void runIntegratorBenchmark(const std::vector<Preset>& presets)
+    {
+        std::printf("\n=== Integrators: cost and accuracy against RK4 with %dx shorter steps ===\n", referenceOversampling);
+        std::printf("%.0f Hz, %d-sample blocks, %.1f s per run after %.1f s of settling.\n",
+                    sampleRate, blockSize, measureSeconds, settleSeconds);
+        std::printf("The measured runs nudge the timestep by +/-%.2f %% every %d samples, as the PID would.\n",
+                    100.0 * pidNudge, pidIntervalSamples);
+        std::printf("pitch: mean frequency of the Z section crossings against the reference, in cents.\n");
+        std::printf("error: largest deviation of X at the output scale over the first %.0f ms, in dBFS.\n\n", horizonSeconds * 1000.0);
+        std::printf("%-18s %-9s %-14s %10s %8s %8s %9s\n", "Preset", "dt", "Integrator", "ns/sample", "x RK4", "pitch", "error");
+
+        const int settleSamples = juce::roundToInt(settleSeconds * sampleRate);
+        const int horizonSamples = juce::roundToInt(horizonSeconds * sampleRate);
+        const int measureSamples = juce::roundToInt(measureSeconds * sampleRate);
+
+        // Geometric mean of the cost ratio, for each integrator and each of the two timesteps
+        double logRatioSums[2][numIntegrators] {};
+
+        for (const auto& preset : presets)
+        {
+            for (int t = 0; t < 2; ++t)
+            {
+                ParameterSnapshot parameters = preset.parameters;
+                parameters.integrator = 0;
+                if (t == 1)
+                    parameters.timestep = maxTimestep;
+
+                std::vector<float> referenceX, referenceZ, unused;
+                const auto startState = renderReference(parameters, settleSamples, horizonSamples, measureSamples, referenceX, referenceZ);
+
+                const auto [level, hysteresis] = getSection(referenceZ);
+                const double referenceFrequency = measureCrossingFrequency(referenceZ, level, hysteresis, sampleRate);
+
+                double rk4Seconds = 0.0;
+
+                for (int integrator = 0; integrator < numIntegrators; ++integrator)
+                {
+                    parameters.integrator = integrator;
+
+                    LorenzOsc osc;
+                    prepare(osc, parameters, sampleRate);
+                    osc.setState(startState);
+
+                    std::vector<float> x, z;
+                    render(osc, horizonSamples, 1, x, unused);
+
+                    float maxError = 0.0f;
+                    for (size_t i = 0; i < x.size(); ++i)
+                        maxError = std::max(maxError, std::abs(x[i] - referenceX[i]) * xScale);
+
+                    const auto start = juce::Time::getHighResolutionTicks();
+                    render(osc, measureSamples, 1, unused, z, parameters.timestep);
+                    const double seconds = secondsSince(start);
+
+                    if (integrator == 0)
+                        rk4Seconds = seconds;
+
+                    const double frequency = measureCrossingFrequency(z, level, hysteresis, sampleRate);
+                    char pitch[16] = "-"; // No regular crossing in one of the two runs
+                    if (frequency > 0.0 && referenceFrequency > 0.0)
+                        std::snprintf(pitch, sizeof (pitch), "%+.1f", 1200.0 * std::log2(frequency / referenceFrequency));
+
+                    const double ratio = seconds / rk4Seconds;
+                    logRatioSums[t][integrator] += std::log(ratio);
+
+                    std::printf("%-18s %-9.5f %-14s %10.1f %8.2f %8s %9.1f\n",
+                                integrator == 0 ? preset.name.toRawUTF8() : "", parameters.timestep, integratorNames[integrator],
+                                1.0e9 * seconds / measureSamples, ratio, pitch,
+                                20.0 * std::log10(std::max(maxError, 1.0e-12f)));
+                }
+            }
+        }
+
+        std::printf("\nGeometric mean of the cost against RK4:\n");
+        for (int integrator = 1; integrator < numIntegrators; ++integrator)
+            std::printf("  %-14s %5.2fx at the presets' timesteps, %5.2fx at dt = %.2f\n", integratorNames[integrator],
+                        std::exp(logRatioSums[0][integrator] / (double) presets.size()),
+                        std::exp(logRatioSums[1][integrator] / (double) presets.size()), maxTimestep);
+    }
+
+    void runSubstepBenchmark(const std::vector<Preset>& presets)
+    {
+        std::printf("\n=== Sub-steps: Rosenbrock against RK4 across the TIMESTEP range ===\n");
+        std::printf("%.0f Hz, %d-sample blocks, %.1f s per run after %.1f s of settling, nudged as the PID would.\n",
+                    sampleRate, blockSize, measureSeconds, settleSeconds);
+        std::printf("steps: sub-steps per sample. pitch: mean frequency of the Z section crossings against\n");
+        std::printf("RK4 with %dx shorter steps, in cents.\n\n", referenceOversampling);
+        std::printf("%-18s %-9s %-11s %6s %10s %8s   %-11s %6s %10s %8s %8s\n", "Preset", "dt",
+                    "Integrator", "steps", "ns/sample", "pitch", "Integrator", "steps", "ns/sample", "pitch", "x RK4");
+
+        const int settleSamples = juce::roundToInt(settleSeconds * sampleRate);
+        const int horizonSamples = juce::roundToInt(horizonSeconds * sampleRate);
+        const int measureSamples = juce::roundToInt(measureSeconds * sampleRate);
+
+        constexpr int numTimesteps = (int) std::size(sweepTimesteps);
+        double logRatioSums[numTimesteps] {};
+        double worstCents[numTimesteps][2] {};
+
+        for (const auto& preset : presets)
+        {
+            for (int t = 0; t < numTimesteps; ++t)
+            {
+                ParameterSnapshot parameters = preset.parameters;
+                parameters.timestep = sweepTimesteps[t];
+
+                std::vector<float> referenceX, referenceZ, unused;
+                const auto startState = renderReference(parameters, settleSamples, horizonSamples, measureSamples, referenceX, referenceZ);
+
+                const auto [level, hysteresis] = getSection(referenceZ);
+                const double referenceFrequency = measureCrossingFrequency(referenceZ, level, hysteresis, sampleRate);
+
+                double seconds[2] {};
+                char pitch[2][16] {};
+
+                for (int i = 0; i < 2; ++i)
+                {
+                    parameters.integrator = i == 0 ? (int) LorenzOsc::Integrator::RK4 : (int) LorenzOsc::Integrator::Rosenbrock;
+
+                    LorenzOsc osc;
+                    prepare(osc, parameters, sampleRate);
+                    osc.setState(startState);
+                    render(osc, horizonSamples, 1, unused, unused);
+
+                    std::vector<float> z;
+                    const auto start = juce::Time::getHighResolutionTicks();
+                    render(osc, measureSamples, 1, unused, z, parameters.timestep);
+                    seconds[i] = secondsSince(start);
+
+                    const double frequency = measureCrossingFrequency(z, level, hysteresis, sampleRate);
+                    std::snprintf(pitch[i], sizeof (pitch[i]), "-"); // No regular crossing in one of the two runs
+                    if (frequency > 0.0 && referenceFrequency > 0.0)
+                    {
+                        const double cents = 1200.0 * std::log2(frequency / referenceFrequency);
+                        std::snprintf(pitch[i], sizeof (pitch[i]), "%+.1f", cents);
+                        worstCents[t][i] = std::max(worstCents[t][i], std::abs(cents));
+                    }
+                }
+
+                const double ratio = seconds[1] / seconds[0];
+                logRatioSums[t] += std::log(ratio);
+
+                std::printf("%-18s %-9.3f %-11s %6d %10.1f %8s   %-11s %6d %10.1f %8s %8.2f\n",
+                            t == 0 ? preset.name.toRawUTF8() : "", parameters.timestep,
+                            "RK4", LorenzOsc::getSubStepsPerSample(LorenzOsc::Integrator::RK4, parameters.timestep),
+                            1.0e9 * seconds[0] / measureSamples, pitch[0],
+                            "Rosenbrock", LorenzOsc::getSubStepsPerSample(LorenzOsc::Integrator::Rosenbrock, parameters.timestep),
+                            1.0e9 * seconds[1] / measureSamples, pitch[1], ratio);
+            }
+        }
+
+        std::printf("\nRosenbrock against RK4, geometric mean of the cost and largest pitch error over the presets:\n");
+        for (int t = 0; t < numTimesteps; ++t)
+            std::printf("  dt = %.3f: %2d against %d sub-steps, %5.2fx the cost, %6.1f cents against %6.1f for RK4\n", sweepTimesteps[t],
+                        LorenzOsc::getSubStepsPerSample(LorenzOsc::Integrator::Rosenbrock, sweepTimesteps[t]),
+                        LorenzOsc::getSubStepsPerSample(LorenzOsc::Integrator::RK4, sweepTimesteps[t]),
+                        std::exp(logRatioSums[t] / (double) presets.size()), worstCents[t][1], worstCents[t][0]);
+    }
+}
@@ -0,0 +1,63 @@
+/*
+  ==============================================================================
+
+    Main.cpp
+    Created: 16 Oct 2026 10:00:00am
+    Author:  Olivier Doaré
+
+  ==============================================================================
+*/
+
+#include "Benchmarks.h"
+
+//==============================================================================
+int main (int argc, char* argv[])
+{
+    // Usage: LorenzBenchmarks [suite...], with no suite to run them all
+    struct Suite
+    {
+        const char* name;
+        void (*run)(const std::vector<Benchmarks::Preset>&);
+    };
+
+    static const Suite suites[] = {
+        { "integrators", Benchmarks::runIntegratorBenchmark },
+        { "substeps", Benchmarks::runSubstepBenchmark },
+        { "bank", Benchmarks::runBankBenchmark },
+        { "predictor", Benchmarks::runPredictorBenchmark },
+        { "detectors", Benchmarks::runDetectorBenchmark }
+    };
+
+    const auto presets = Benchmarks::loadFactoryPresets();
+    if (presets.empty())
+    {
+        std::printf("No factory presets found\n");
+        return 1;
+    }
+
+    bool ranAny = false;
+
+    for (const auto& suite : suites)
+    {
+        bool selected = argc <= 1;
+        for (int i = 1; i < argc; ++i)
+            selected = selected || std::strcmp(argv[i], suite.name) == 0;
+
+        if (selected)
+        {
+            suite.run(presets);
+            ranAny = true;
+        }
+    }
+
+    if (! ranAny)
+    {
+        std::printf("Usage: %s [", argv[0]);
+        for (size_t i = 0; i < std::size(suites); ++i)
+            std::printf("%s%s", i > 0 ? "|" : "", suites[i].name);
+        std::printf("]...\n");
+        return 1;
+    }
+
+    return 0;
+}
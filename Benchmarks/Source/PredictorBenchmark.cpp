@@ -0,0 +1,200 @@
+/*
+  ==============================================================================
+
+    PredictorBenchmark.cpp
+    Created: 16 Oct 2026 10:00:00am
+    Author:  Olivier Doaré
+
+  ==============================================================================
+*/
+
+#include "Benchmarks.h"
+#include "../../Source/TimestepPredictor.h"
+#include "../../Source/PitchAnalyser.h"
+#include "../../Source/PoincareEstimator.h"
+#include "../../Source/FrequencyTracker.h"
+
+namespace
+{
+    // As in the processor
+    constexpr int analysisWindowSize = 4096;
+    constexpr int analysisHopSize = 1024;
+    constexpr float sectionHysteresis = 0.5f;
+    constexpr float minTimestep = 0.0001f, maxTimestep = 0.05f;
+
+    // The worker waits for the parameters to settle, then runs 16 simulations
+    constexpr double maxTableSeconds = 60.0;
+
+    constexpr double settleSeconds = 0.5;
+    constexpr double measureSeconds = 2.0;
+
+    // Notes around the preset's target frequency, in semitones
+    constexpr int noteOffsets[] = { -12, 0, 12 };
+
+    const char* const detectorNames[] = { "MPM", "YIN", "ZeroCrossing" };
+    const char* const sourceNames[] = { "X", "Y", "Z", "Z section", "X section", "Y section" };
+
+    /** Waits for the predictor's table for the parameters. False on a time-out. */
+    bool waitForTable(TimestepPredictor& predictor, const ParameterSnapshot& parameters)
+    {
+        const auto start = juce::Time::getHighResolutionTicks();
+
+        while (Benchmarks::secondsSince(start) < maxTableSeconds)
+        {
+            predictor.setAttractor(parameters);
+            if (predictor.predictTimestep(parameters.targetFrequency) > 0.0f)
+                return true;
+
+            juce::Thread::sleep(20);
+        }
+
+        return false;
+    }
+
+    /**
+     * Plays the attractor at the timestep and measures it as the monophonic
+     * lock does: the median of the trusted PitchAnalyser estimates for a signal
+     * source, or the Poincaré section for a section source.
+     */
+    float measureLockedFrequency(const ParameterSnapshot& parameters, float timestep)
+    {
+        ParameterSnapshot played = parameters;
+        played.timestep = timestep;
+
+        LorenzOsc osc;
+        osc.prepareToPlay(Benchmarks::sampleRate);
+        osc.setParameters(played);
+        osc.reset();
+
+        static constexpr int coordinates[] = { 0, 1, 2, 2, 0, 1 };
+        static constexpr float scales[] = { Benchmarks::xScale, Benchmarks::yScale, Benchmarks::zScale };
+        const int source = juce::jlimit(0, 5, parameters.pitchSource);
+        const int coordinate = coordinates[source];
+
+        PitchAnalyser analyser;
+        analyser.prepare(Benchmarks::sampleRate, analysisWindowSize, true);
+        analyser.setDetector(static_cast<PitchDetector::Type>(parameters.pitchDetector));
+        analyser.setTargetFrequency(parameters.targetFrequency);
+        analyser.setHopSize(analysisHopSize);
+
+        PoincareEstimator section;
+        section.prepare(Benchmarks::sampleRate);
+        section.setSection(coordinate == 2 ? parameters.rho - 1.0f : 0.0f, sectionHysteresis);
+
+        std::vector<float> buffers[3];
+        for (auto& buffer : buffers)
+            buffer.resize((size_t) Benchmarks::blockSize);
+
+        std::vector<float> estimates;
+        uint32_t lastEstimateTime = 0;
+
+        const int settleSamples = juce::roundToInt(settleSeconds * Benchmarks::sampleRate);
+        const int totalSamples = settleSamples + juce::roundToInt(measureSeconds * Benchmarks::sampleRate);
+
+        for (int done = 0; done < totalSamples; done += Benchmarks::blockSize)
+        {
+            osc.renderBlock(buffers[0].data(), buffers[1].data(), buffers[2].data(), Benchmarks::blockSize);
+            if (done < settleSamples)
+                continue;
+
+            if (source >= 3)
+            {
+                for (const float value : buffers[(size_t) coordinate])
+                    section.pushSample(value);
+
+                continue;
+            }
+
+            for (auto& value : buffers[(size_t) coordinate])
+                value *= scales[coordinate];
+
+            analyser.pushSamples(buffers[(size_t) coordinate].data(), Benchmarks::blockSize);
+
+            if (analyser.getLatestEstimateTime() != lastEstimateTime)
+            {
+                lastEstimateTime = analyser.getLatestEstimateTime();
+                if (analyser.getLatestEstimate() > 0.0f && analyser.getLatestConfidence() >= FrequencyTracker::minConfidence)
+                    estimates.push_back(analyser.getLatestEstimate());
+            }
+        }
+
+        if (source >= 3)
+            return section.getFrequency();
+
+        if (estimates.empty())
+            return 0.0f;
+
+        const auto middle = estimates.begin() + (std::ptrdiff_t) (estimates.size() / 2);
+        std::nth_element(estimates.begin(), middle, estimates.end());
+        return *middle;
+    }
+}
+
+namespace Benchmarks
+{
+    void runPredictorBenchmark(const std::vector<Preset>& presets)
+    {
+        std::printf("\n=== Timestep predictor: pitch at the predicted timestep, as the monophonic lock measures it ===\n");
+        std::printf("Signal sources are measured with each detector, over %d-sample windows every %d samples;\n",
+                    analysisWindowSize, analysisHopSize);
+        std::printf("section sources with the Poincare section. error: measured pitch against the note, in cents.\n");
+        std::printf("Notes the TIMESTEP range cannot reach are marked as such and left out of the totals.\n\n");
+        std::printf("%-18s %-10s %-13s %8s %9s %9s\n", "Preset", "Source", "Detector", "Note Hz", "dt", "error");
+
+        TimestepPredictor predictor;
+        predictor.prepare(sampleRate, analysisWindowSize, minTimestep, maxTimestep);
+
+        int numNotes = 0, numWithin1Cent = 0, numWithin10Cents = 0, numOutOfRange = 0;
+
+        for (const auto& preset : presets)
+        {
+            const int source = juce::jlimit(0, 5, preset.parameters.pitchSource);
+            const int numDetectors = source >= 3 ? 1 : 3;
+
+            for (int detector = 0; detector < numDetectors; ++detector)
+            {
+                ParameterSnapshot parameters = preset.parameters;
+                parameters.pitchDetector = detector;
+                parameters.polyphony = 0;
+
+                if (! waitForTable(predictor, parameters))
+                {
+                    std::printf("%-18s %-10s %-13s no table\n", preset.name.toRawUTF8(), sourceNames[source],
+                                source >= 3 ? "-" : detectorNames[detector]);
+                    continue;
+                }
+
+                for (const int offset : noteOffsets)
+                {
+                    parameters.targetFrequency = preset.parameters.targetFrequency * std::pow(2.0f, offset / 12.0f);
+                    const float timestep = predictor.predictTimestep(parameters.targetFrequency);
+                    const float frequency = timestep > 0.0f ? measureLockedFrequency(parameters, timestep) : 0.0f;
+
+                    char error[16] = "-"; // No prediction, or no pitch at it
+                    if (timestep <= minTimestep || timestep >= maxTimestep)
+                    {
+                        std::snprintf(error, sizeof (error), "range");
+                        ++numOutOfRange;
+                    }
+                    else if (frequency > 0.0f)
+                    {
+                        const double cents = 1200.0 * std::log2(frequency / parameters.targetFrequency);
+                        std::snprintf(error, sizeof (error), "%+.1f", cents);
+
+                        numWithin1Cent += std::abs(cents) <= 1.0 ? 1 : 0;
+                        numWithin10Cents += std::abs(cents) <= 10.0 ? 1 : 0;
+                    }
+
+                    numNotes += timestep > minTimestep && timestep < maxTimestep ? 1 : 0;
+
+                    std::printf("%-18s %-10s %-13s %8.1f %9.5f %9s\n",
+                                offset == noteOffsets[0] ? preset.name.toRawUTF8() : "", sourceNames[source],
+                                source >= 3 ? "-" : detectorNames[detector], parameters.targetFrequency, timestep, error);
+                }
+            }
+        }
+
+        std::printf("\n%d of %d notes within 1 cent, %d within 10 cents, %d out of range.\n",
+                    numWithin1Cent, numNotes, numWithin10Cents, numOutOfRange);
+    }
+}
@@ -30,14 +30,9 @@ float ADSR::process()
     return value;
 }
 
-void ADSR::setParameters (const ADSRParameters& params)
+void ADSR::setParameters (const juce::ADSR::Parameters& params)
 {
-    juce::ADSR::Parameters adsrParams;
-    adsrParams.attack  = params.attack;
-    adsrParams.decay   = params.decay;
-    adsrParams.sustain = params.sustain;
-    adsrParams.release = params.release;
-    adsr.setParameters (adsrParams);
+    adsr.setParameters (params);
 }
 
 void ADSR::applyEnvelopeToBuffer (juce::AudioBuffer<float>& buffer, int startSample, int numSamples)
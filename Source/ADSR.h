@@ -15,7 +15,6 @@
 #pragma once
 
 #include "Modulator.h"
-#include "ParameterStructs.h"
 
 class ADSR : public Modulator
 {
@@ -26,7 +25,7 @@ public:
     void prepareToPlay (double sampleRate) override;
     float process() override;
 
-    void setParameters (const ADSRParameters& params);
+    void setParameters (const juce::ADSR::Parameters& params);
 
     void applyEnvelopeToBuffer (juce::AudioBuffer<float>& buffer, int startSample, int numSamples);
 
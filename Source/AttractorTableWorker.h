@@ -0,0 +1,179 @@
+/*
+  ==============================================================================
+
+    AttractorTableWorker.h
+    Created: 16 Oct 2026 10:00:00am
+    Author:  Olivier Doaré
+
+  ==============================================================================
+*/
+
+#pragma once
+
+#include <JuceHeader.h>
+#include "ParameterSnapshot.h"
+
+/**
+ * A background thread that builds a table for the current attractor, such as
+ * the TimestepPredictor's timestep -> frequency table or the WarmStartCache's
+ * snapshots.
+ *
+ * The audio thread hands over the block's parameters with requestTable(). A
+ * parameter that changes the attractor (see isSameAttractor()) bumps the
+ * request generation, and the worker builds a new table once the parameters
+ * have been still for a short while, so dragging a slider does not restart it
+ * each block. A build gives up as soon as its request is superseded.
+ *
+ * The tables go through a triple buffer: the worker writes its own table, the
+ * audio thread reads its own, and a finished table is handed over by swapping
+ * it with the shared one, so neither side ever touches the other's table.
+ *
+ * Table needs a uint32_t generation member, set here once a build succeeds.
+ * Derived classes stop the worker in their destructor, before their own
+ * members go.
+ */
+template <typename Table>
+class AttractorTableWorker : private juce::Thread
+{
+protected:
+    explicit AttractorTableWorker(const juce::String& threadName) : juce::Thread(threadName) {}
+
+    /** Forgets the current table and starts the worker. Not real-time safe. */
+    void startWorker()
+    {
+        stopWorker();
+
+        // Tables built for earlier settings are stale
+        hasRequest = false;
+        requestGeneration.fetch_add(1);
+
+        startThread();
+    }
+
+    /** Stops the worker. */
+    void stopWorker() { stopThread(2000); }
+
+    /**
+     * Picks up the latest table, then hands over the block's parameters and
+     * requests a new table if the attractor changed. Audio thread.
+     */
+    void requestTable(const ParameterSnapshot& parameters)
+    {
+        // Swap in the worker's last table, if there is a new one. The one given
+        // back is not read again until the next swap.
+        if ((latestTable.load(std::memory_order_relaxed) & freshTable) != 0)
+            readTable = latestTable.exchange(readTable, std::memory_order_acq_rel) & ~freshTable;
+
+        if (hasRequest && isSameAttractor(parameters, lastRequest))
+            return;
+
+        // If the worker is copying the previous request, try again next block.
+        const juce::SpinLock::ScopedTryLockType lock (requestLock);
+        if (! lock.isLocked())
+            return;
+
+        request = parameters;
+        requestGeneration.fetch_add(1, std::memory_order_release);
+        lastRequest = parameters;
+        hasRequest = true;
+    }
+
+    /** The audio thread's table. Audio thread. */
+    const Table& getTable() const { return tables[(size_t) readTable]; }
+
+    /** True if the audio thread's table was built for the current attractor. Audio thread. */
+    bool isTableCurrent() const { return getTable().generation == requestGeneration.load(std::memory_order_relaxed); }
+
+    /** True once a build for the given generation should stop. Worker thread. */
+    bool isSuperseded(uint32_t generation) const
+    {
+        return threadShouldExit() || requestGeneration.load(std::memory_order_relaxed) != generation;
+    }
+
+    /** Fills the table for the parameters. Returns false if the build was superseded. Worker thread. */
+    virtual bool buildTable(Table& table, const ParameterSnapshot& parameters, uint32_t generation) = 0;
+
+    /** False for a built table that must not replace the audio thread's one. Worker thread. */
+    virtual bool shouldPublish(const Table&) const { return true; }
+
+    /**
+     * True if the table built for a also holds for b. By default, the
+     * parameters that change the attractor's shape and its period in
+     * simulation time; not the timestep, which only sets how fast it plays.
+     */
+    virtual bool isSameAttractor(const ParameterSnapshot& a, const ParameterSnapshot& b) const
+    {
+        return a.sigma == b.sigma && a.rho == b.rho && a.beta == b.beta
+            && a.mx == b.mx && a.my == b.my && a.mz == b.mz
+            && a.cx == b.cx && a.cy == b.cy && a.cz == b.cz
+            && a.taming == b.taming && a.integrator == b.integrator;
+    }
+
+private:
+    // A new table is only built once the parameters have been stable this long
+    static constexpr uint32_t settleMilliseconds = 100;
+
+    void run() override
+    {
+        uint32_t builtGeneration = 0;
+        uint32_t seenGeneration = 0;
+        uint32_t seenTime = 0;
+
+        while (! threadShouldExit())
+        {
+            wait(20);
+
+            const uint32_t generation = requestGeneration.load(std::memory_order_acquire);
+            if (generation == builtGeneration)
+                continue;
+
+            // Wait until the parameters stop changing
+            const uint32_t now = juce::Time::getMillisecondCounter();
+            if (generation != seenGeneration)
+            {
+                seenGeneration = generation;
+                seenTime = now;
+                continue;
+            }
+
+            if (now - seenTime < settleMilliseconds)
+                continue;
+
+            ParameterSnapshot parameters;
+            {
+                const juce::SpinLock::ScopedLockType lock (requestLock);
+                parameters = request;
+            }
+
+            Table& table = tables[(size_t) writeTable];
+
+            if (buildTable(table, parameters, generation))
+            {
+                table.generation = generation;
+
+                if (shouldPublish(table))
+                    writeTable = latestTable.exchange(writeTable | freshTable, std::memory_order_acq_rel) & ~freshTable;
+
+                builtGeneration = generation;
+            }
+        }
+    }
+
+    // --- Audio thread -> worker ---
+    juce::SpinLock requestLock;
+    ParameterSnapshot request;
+    std::atomic<uint32_t> requestGeneration { 0 };
+
+    // --- Audio thread state ---
+    ParameterSnapshot lastRequest;
+    bool hasRequest = false;
+    int readTable = 0;
+
+    // --- Worker -> audio thread: the last finished table, flagged until the audio thread takes it ---
+    static constexpr int freshTable = 4;
+    std::array<Table, 3> tables;
+    std::atomic<int> latestTable { 1 };
+
+    // --- Worker state ---
+    int writeTable = 2;
+};
@@ -0,0 +1,66 @@
+/*
+  ==============================================================================
+
+    ControlClock.h
+    Created: 16 Oct 2026 10:00:00am
+    Author:  Olivier Doaré
+
+  ==============================================================================
+*/
+
+#pragma once
+
+#include <JuceHeader.h>
+
+/**
+ * Countdown to the next tick of a task that runs every interval samples, such
+ * as the modulation matrix or the pitch controller.
+ *
+ * The processor splits each block into sub-blocks that end at the next tick of
+ * any clock or at the next MIDI event, so every task and every event lands on
+ * its exact sample, and the oscillator renders each sub-block in one call:
+ *
+ *     for (int start = 0; start < numSamples;)
+ *     {
+ *         if (clock.tick())
+ *             runTask();
+ *
+ *         const int length = juce::jmin(numSamples - start, clock.getSamplesUntilTick());
+ *         render(start, length);
+ *         clock.advance(length);
+ *         start += length;
+ *     }
+ */
+class ControlClock
+{
+public:
+    ControlClock() = default;
+
+    /** Changes the interval from the next tick on. */
+    void setInterval(int numSamples) noexcept { interval = juce::jmax(1, numSamples); }
+
+    int getInterval() const noexcept { return interval; }
+
+    /** Makes a tick due at the current position. */
+    void restart() noexcept { samplesUntilTick = 0; }
+
+    /** Returns true, and schedules the next tick, if a tick is due at the current position. */
+    bool tick() noexcept
+    {
+        if (samplesUntilTick > 0)
+            return false;
+
+        samplesUntilTick = interval;
+        return true;
+    }
+
+    /** Samples left before the next tick: the longest sub-block that does not skip it. */
+    int getSamplesUntilTick() const noexcept { return samplesUntilTick; }
+
+    /** Moves the current position on by a rendered sub-block. */
+    void advance(int numSamples) noexcept { samplesUntilTick -= numSamples; }
+
+private:
+    int interval = 1;
+    int samplesUntilTick = 0;
+};
@@ -0,0 +1,46 @@
+/*
+  ==============================================================================
+
+    Decimator.cpp
+    Created: 16 Oct 2026 10:00:00am
+    Author:  Olivier Doaré
+
+  ==============================================================================
+*/
+
+#include "Decimator.h"
+
+Decimator::Decimator()
+{
+    // Blackman-windowed sinc with its cutoff at a quarter of the input rate.
+    // The side taps are normalised so they sum to 0.5, giving unity DC gain
+    // together with the 0.5 centre tap.
+    float sum = 0.0f;
+
+    for (int j = 0; j < numSideTaps; ++j)
+    {
+        const int n = 2 * j + 1;
+        const double x = juce::MathConstants<double>::pi * n / 2.0;
+        const double sinc = std::sin(x) / x;
+        const double phase = juce::MathConstants<double>::twoPi * (centreTap + n) / (numTaps - 1);
+        const double window = 0.42 - 0.5 * std::cos(phase) + 0.08 * std::cos(2.0 * phase);
+
+        coefficients[(size_t) j] = static_cast<float>(0.5 * sinc * window);
+        sum += 2.0f * coefficients[(size_t) j];
+    }
+
+    for (auto& c : coefficients)
+        c *= 0.5f / sum;
+}
+
+void Decimator::setFactor(int newFactor)
+{
+    numStages = newFactor >= 8 ? 3 : newFactor >= 4 ? 2 : newFactor >= 2 ? 1 : 0;
+    reset();
+}
+
+void Decimator::reset()
+{
+    for (auto& stage : stages)
+        stage.reset();
+}
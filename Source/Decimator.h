@@ -0,0 +1,105 @@
+/*
+  ==============================================================================
+
+    Decimator.h
+    Created: 16 Oct 2026 10:00:00am
+    Author:  Olivier Doaré
+
+  ==============================================================================
+*/
+
+#pragma once
+
+#include <JuceHeader.h>
+
+/**
+ * Downsamples a signal by 1, 2, 4 or 8 with a cascade of polyphase half-band
+ * low-pass stages.
+ *
+ * Each stage halves the rate. Only every second output of a half-band filter
+ * is needed and every other tap is zero, so a stage costs about a quarter of
+ * the taps per input sample.
+ */
+class Decimator
+{
+public:
+    static constexpr int maxFactor = 8;
+
+    Decimator();
+
+    /** Sets the decimation factor (1, 2, 4 or 8) and clears the filter state. */
+    void setFactor(int newFactor);
+    int getFactor() const { return 1 << numStages; }
+
+    /** Clears the filter state. */
+    void reset();
+
+    /**
+     * Feeds one input sample.
+     * @return true if a decimated sample was produced and written to output.
+     */
+    bool processSample(float input, float& output) noexcept
+    {
+        for (int i = 0; i < numStages; ++i)
+            if (! stages[(size_t) i].process(input, input, coefficients))
+                return false;
+
+        output = input;
+        return true;
+    }
+
+    /** Group delay of the whole cascade, in input samples. */
+    int getLatencySamples() const { return centreTap * (getFactor() - 1); }
+
+private:
+    static constexpr int numTaps = 31;
+    static constexpr int centreTap = numTaps / 2;
+    static constexpr int numSideTaps = (centreTap + 1) / 2;
+
+    // Non-zero taps on one side of the centre, at odd distances 1, 3, 5...
+    using Coefficients = std::array<float, numSideTaps>;
+
+    struct HalfBandStage
+    {
+        // Delay line written twice, so the latest numTaps samples are contiguous
+        std::array<float, 2 * numTaps> delay {};
+        int position = 0;
+        bool outputDue = false;
+
+        void reset()
+        {
+            delay.fill(0.0f);
+            position = 0;
+            outputDue = false;
+        }
+
+        bool process(float input, float& output, const Coefficients& c) noexcept
+        {
+            delay[(size_t) position] = input;
+            delay[(size_t) (position + numTaps)] = input;
+
+            if (++position == numTaps)
+                position = 0;
+
+            outputDue = ! outputDue;
+            if (! outputDue)
+                return false;
+
+            // Oldest sample first
+            const float* w = delay.data() + position;
+            float sum = 0.5f * w[centreTap];
+
+            for (int j = 0; j < numSideTaps; ++j)
+                sum += c[(size_t) j] * (w[centreTap - (2 * j + 1)] + w[centreTap + (2 * j + 1)]);
+
+            output = sum;
+            return true;
+        }
+    };
+
+    Coefficients coefficients {};
+    std::array<HalfBandStage, 3> stages;
+    int numStages = 0;
+
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR (Decimator)
+};
@@ -0,0 +1,119 @@
+/*
+  ==============================================================================
+
+    FrequencyTracker.cpp
+    Created: 16 Oct 2026 10:00:00am
+    Author:  Olivier Doaré
+
+  ==============================================================================
+*/
+
+#include "FrequencyTracker.h"
+
+void FrequencyTracker::reset()
+{
+    pitch = rate = 0.0;
+    p11 = p12 = p22 = 0.0;
+    tracking = false;
+    secondsSinceMeasurement = 0.0f;
+    consecutiveOutliers = 0;
+}
+
+void FrequencyTracker::restart(double newPitch)
+{
+    pitch = newPitch;
+    rate = 0.0;
+    p11 = measurementNoise * measurementNoise;
+    p12 = 0.0;
+    p22 = initialRateDeviation * initialRateDeviation;
+    tracking = true;
+    secondsSinceMeasurement = 0.0f;
+    consecutiveOutliers = 0;
+}
+
+void FrequencyTracker::predict(float seconds)
+{
+    if (! tracking || seconds <= 0.0f)
+        return;
+
+    secondsSinceMeasurement += seconds;
+
+    if (secondsSinceMeasurement > maxCoastSeconds)
+    {
+        reset();
+        return;
+    }
+
+    const double t = seconds;
+    pitch += rate * t;
+
+    // P = F P F' + Q, with F = [1 t; 0 1] and the white-acceleration Q
+    p11 += 2.0 * t * p12 + t * t * p22 + accelerationNoise * t * t * t / 3.0;
+    p12 += t * p22 + accelerationNoise * t * t / 2.0;
+    p22 += accelerationNoise * t;
+
+    // Without estimates, do not follow a slope for long
+    if (secondsSinceMeasurement > rateHoldSeconds)
+        rate *= std::exp(-t / rateFadeSeconds);
+}
+
+void FrequencyTracker::scaleFrequency(float ratio)
+{
+    if (tracking && ratio > 0.0f)
+        pitch += std::log2((double) ratio);
+}
+
+bool FrequencyTracker::addMeasurement(float frequency, float confidence, float ageSeconds)
+{
+    if (frequency <= 0.0f || confidence < minConfidence)
+        return false;
+
+    const double measured = std::log2((double) frequency);
+
+    if (! tracking)
+    {
+        restart(measured);
+        return true;
+    }
+
+    // The estimate describes the pitch ageSeconds ago: H = [1, -age]. The
+    // random acceleration over that time adds to the measurement noise.
+    const double age = juce::jmax(0.0f, ageSeconds);
+    const double deviation = measurementNoise / confidence;
+    const double noise = deviation * deviation + accelerationNoise * age * age * age / 3.0;
+
+    const double ph1 = p11 - age * p12;
+    const double ph2 = p12 - age * p22;
+    const double innovationVariance = ph1 - age * ph2 + noise;
+    const double innovation = measured - (pitch - age * rate);
+
+    if (innovation * innovation > gateThreshold * innovationVariance)
+    {
+        // One wild estimate is an outlier; several in a row mean the pitch moved
+        if (++consecutiveOutliers < maxConsecutiveOutliers)
+            return false;
+
+        restart(measured);
+        return true;
+    }
+
+    const double k1 = ph1 / innovationVariance;
+    const double k2 = ph2 / innovationVariance;
+
+    pitch += k1 * innovation;
+    rate = juce::jlimit(-maxRate, maxRate, rate + k2 * innovation);
+
+    // P = P - K H P
+    p11 -= k1 * ph1;
+    p12 -= k1 * ph2;
+    p22 -= k2 * ph2;
+
+    secondsSinceMeasurement = 0.0f;
+    consecutiveOutliers = 0;
+    return true;
+}
+
+float FrequencyTracker::getFrequency() const
+{
+    return tracking ? static_cast<float>(std::exp2(pitch)) : 0.0f;
+}
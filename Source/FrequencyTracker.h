@@ -0,0 +1,86 @@
+/*
+  ==============================================================================
+
+    FrequencyTracker.h
+    Created: 16 Oct 2026 10:00:00am
+    Author:  Olivier Doaré
+
+  ==============================================================================
+*/
+
+#pragma once
+
+#include <JuceHeader.h>
+
+/**
+ * Kalman filter that tracks the pitch of the oscillator and its rate of
+ * change from the pitch estimates, and gives the controller a smooth,
+ * up-to-date frequency at whatever rate it runs.
+ *
+ * The state is (pitch, rate) in octaves and octaves per second, so the same
+ * noise levels hold in every register and an octave error is the same size
+ * up or down. Between estimates the pitch follows its rate; each estimate is
+ * weighted by the detector's confidence and compared with the state as it was
+ * when its window was recorded, so the analysis latency is compensated.
+ *
+ * Estimates with no pitch or a low confidence are skipped and the tracker
+ * coasts on its prediction, with the rate fading out after a while, for up to
+ * maxCoastSeconds. Estimates far outside the expected spread are rejected as
+ * outliers (e.g. octave errors), unless several arrive in a row, in which case
+ * the tracker starts again from the new pitch.
+ */
+class FrequencyTracker
+{
+public:
+    FrequencyTracker() { reset(); }
+
+    /** Forgets the tracked pitch. */
+    void reset();
+
+    /** Advances the state by the given time. */
+    void predict(float seconds);
+
+    /** Applies a known change of frequency, e.g. from a change of timestep, to the tracked pitch. */
+    void scaleFrequency(float ratio);
+
+    /**
+     * Fuses an estimate of the frequency ageSeconds ago. Estimates of 0 Hz or
+     * with a confidence below minConfidence count as dropouts. Returns true
+     * if the estimate was taken in, false for a dropout or a rejected outlier.
+     */
+    bool addMeasurement(float frequency, float confidence, float ageSeconds);
+
+    /** True while a pitch is being tracked. */
+    bool isTracking() const { return tracking; }
+
+    /** The tracked frequency in Hz, or 0 if no pitch is tracked. */
+    float getFrequency() const;
+
+    // Estimates below this confidence are not trusted
+    static constexpr float minConfidence = 0.3f;
+
+private:
+    void restart(double newPitch);
+
+    // Spectral density of the random acceleration of the pitch, in (octaves/s^2)^2 per Hz.
+    // Kept low: the controller's own changes come in through scaleFrequency(),
+    // and a noisy rate, extrapolated over the analysis latency, costs more than
+    // it gains. Real jumps are caught by the outlier restart instead.
+    static constexpr double accelerationNoise = 0.001;
+    // Standard deviation in octaves of an estimate with full confidence (about 4 cents)
+    static constexpr double measurementNoise = 0.003;
+    static constexpr double initialRateDeviation = 1.0;   // octaves/s
+    static constexpr double maxRate = 8.0;                // octaves/s
+    static constexpr double gateThreshold = 9.0;          // Squared normalised innovation, 3 sigma
+    static constexpr int maxConsecutiveOutliers = 3;
+    static constexpr float maxCoastSeconds = 0.5f;
+    static constexpr float rateHoldSeconds = 0.25f;      // Coasting time before the rate fades
+    static constexpr float rateFadeSeconds = 0.1f;
+
+    double pitch = 0.0, rate = 0.0;
+    double p11 = 0.0, p12 = 0.0, p22 = 0.0; // Symmetric covariance
+
+    bool tracking = false;
+    float secondsSinceMeasurement = 0.0f;
+    int consecutiveOutliers = 0;
+};
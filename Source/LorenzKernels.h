@@ -0,0 +1,162 @@
+/*
+  ==============================================================================
+
+    LorenzKernels.h
+    Created: 16 Oct 2026 10:00:00am
+    Author:  Olivier Doaré
+
+  ==============================================================================
+*/
+
+#pragma once
+
+#include <JuceHeader.h>
+
+/**
+ * Compile-time specialised derivative and RK4 kernels for the second-order
+ * Lorenz system.
+ *
+ * The policies remove work that the current parameters make useless:
+ *  - Tamed:       when false, the cubic taming terms are not computed at all.
+ *  - UniformMass: when true, a single reciprocal mass is used for all three axes.
+ * The kernels work in double precision, as every integrator of the plugin does.
+ *
+ * The masses are passed as reciprocals, computed once per block (or per
+ * control tick while they ramp), so the innermost loop has no divisions.
+ */
+namespace LorenzKernels
+{
+    /** Longest RK4 step that keeps the integration stable. Longer timesteps are split into sub-steps. */
+    constexpr float maxSimulationTimestep = 0.005f;
+
+    template <typename FloatType>
+    struct Coefficients
+    {
+        FloatType sigma, rho, beta;
+        FloatType invMx, invMy, invMz;
+        FloatType cx, cy, cz;
+        FloatType taming;
+    };
+
+    // State vector: x, y, z, vx, vy, vz
+    template <typename FloatType>
+    using State = std::array<FloatType, 6>;
+
+    /** The state every attractor starts from after a reset. */
+    template <typename FloatType>
+    constexpr State<FloatType> initialState { FloatType(0.1), 0, 0, 0, 0, 0 };
+
+    template <bool Tamed, bool UniformMass>
+    struct Kernel
+    {
+        using FloatType = double;
+        using Coeffs = Coefficients<FloatType>;
+        using StateType = State<FloatType>;
+
+        /** Accelerations at one position and velocity: the forces divided by the masses. */
+        static inline void accelerations(const Coeffs& c, FloatType tX, FloatType tY, FloatType tZ,
+                                         FloatType tVx, FloatType tVy, FloatType tVz,
+                                         FloatType& aX, FloatType& aY, FloatType& aZ) noexcept
+        {
+            FloatType forceX = c.sigma * (tY - tX) - c.cx * tVx;
+            FloatType forceY = tX * (c.rho - tZ) - tY - c.cy * tVy;
+            FloatType forceZ = tX * tY - c.beta * tZ - c.cz * tVz;
+
+            if constexpr (Tamed)
+            {
+                // Non-linear damping term: -taming * v^3. This opposes the velocity.
+                forceX -= c.taming * tVx * tVx * tVx;
+                forceY -= c.taming * tVy * tVy * tVy;
+                forceZ -= c.taming * tVz * tVz * tVz;
+            }
+
+            if constexpr (UniformMass)
+            {
+                aX = forceX * c.invMx;
+                aY = forceY * c.invMx;
+                aZ = forceZ * c.invMx;
+            }
+            else
+            {
+                aX = forceX * c.invMx;
+                aY = forceY * c.invMy;
+                aZ = forceZ * c.invMz;
+            }
+        }
+
+        /** Time derivative of the state. The position derivatives are the velocities themselves. */
+        static inline void derivatives(const Coeffs& c, const StateType& s, StateType& d) noexcept
+        {
+            d[0] = s[3];
+            d[1] = s[4];
+            d[2] = s[5];
+            accelerations(c, s[0], s[1], s[2], s[3], s[4], s[5], d[3], d[4], d[5]);
+        }
+
+        /** Advances the state by numSubSteps fourth-order Runge-Kutta steps of length h. */
+        static inline void rk4(StateType& s, const Coeffs& c, FloatType h, int numSubSteps) noexcept
+        {
+            const FloatType halfH = h * FloatType (0.5);
+            const FloatType sixthH = h / FloatType (6);
+
+            StateType k1, k2, k3, k4, tmp;
+
+            for (int i = 0; i < numSubSteps; ++i)
+            {
+                // k1: Evaluate derivatives at the current state
+                derivatives(c, s, k1);
+
+                // k2: Evaluate at midpoint using k1
+                for (size_t j = 0; j < s.size(); ++j) tmp[j] = s[j] + halfH * k1[j];
+                derivatives(c, tmp, k2);
+
+                // k3: Evaluate at midpoint using k2
+                for (size_t j = 0; j < s.size(); ++j) tmp[j] = s[j] + halfH * k2[j];
+                derivatives(c, tmp, k3);
+
+                // k4: Evaluate at the end of the step using k3
+                for (size_t j = 0; j < s.size(); ++j) tmp[j] = s[j] + h * k3[j];
+                derivatives(c, tmp, k4);
+
+                // Update state using the weighted average of the k-values
+                for (size_t j = 0; j < s.size(); ++j)
+                    s[j] += sixthH * (k1[j] + FloatType (2) * k2[j] + FloatType (2) * k3[j] + k4[j]);
+            }
+        }
+    };
+
+    /** Fills a coefficient set from raw parameter values. */
+    template <typename FloatType>
+    inline Coefficients<FloatType> makeCoefficients(float sigma, float rho, float beta,
+                                                    float mx, float my, float mz,
+                                                    float cx, float cy, float cz, float taming) noexcept
+    {
+        return { FloatType (sigma), FloatType (rho), FloatType (beta),
+                 FloatType (1) / FloatType (mx), FloatType (1) / FloatType (my), FloatType (1) / FloatType (mz),
+                 FloatType (cx), FloatType (cy), FloatType (cz),
+                 FloatType (taming) };
+    }
+
+    /** Per-sample increment that takes a coefficient set from one value to another in numSteps samples. */
+    template <typename FloatType>
+    inline Coefficients<FloatType> rampIncrement(const Coefficients<FloatType>& from,
+                                                 const Coefficients<FloatType>& to, int numSteps) noexcept
+    {
+        const FloatType k = FloatType (1) / FloatType (numSteps);
+
+        return { (to.sigma - from.sigma) * k, (to.rho - from.rho) * k, (to.beta - from.beta) * k,
+                 (to.invMx - from.invMx) * k, (to.invMy - from.invMy) * k, (to.invMz - from.invMz) * k,
+                 (to.cx - from.cx) * k, (to.cy - from.cy) * k, (to.cz - from.cz) * k,
+                 (to.taming - from.taming) * k };
+    }
+
+    /** Adds a ramp increment to a coefficient set. */
+    template <typename FloatType>
+    inline void advance(Coefficients<FloatType>& c, const Coefficients<FloatType>& increment) noexcept
+    {
+        c.sigma += increment.sigma;   c.rho += increment.rho;     c.beta += increment.beta;
+        c.invMx += increment.invMx;   c.invMy += increment.invMy; c.invMz += increment.invMz;
+        c.cx += increment.cx;         c.cy += increment.cy;       c.cz += increment.cz;
+        c.taming += increment.taming;
+    }
+} // namespace LorenzKernels
@@ -12,6 +12,7 @@
 
 LorenzOsc::LorenzOsc()
 {
+    setParameters(ParameterSnapshot {});
     reset();
     sampleRate = 44100.0;
     rampDurationSeconds = 0.05; // 50ms default ramp time
@@ -21,17 +22,26 @@ LorenzOsc::LorenzOsc()
 void LorenzOsc::prepareToPlay(double sr)
 {
     sampleRate = sr;
-    sigma.reset(sampleRate, rampDurationSeconds);
-    rho.reset(sampleRate, rampDurationSeconds);
-    beta.reset(sampleRate, rampDurationSeconds);
-    mx.reset(sampleRate, rampDurationSeconds);
-    my.reset(sampleRate, rampDurationSeconds);
-    mz.reset(sampleRate, rampDurationSeconds);
-    cx.reset(sampleRate, rampDurationSeconds);
-    cy.reset(sampleRate, rampDurationSeconds);
-    cz.reset(sampleRate, rampDurationSeconds);
-    taming.reset(sampleRate, rampDurationSeconds);
-    dt.reset(sampleRate, rampDurationSeconds);
+    resetSmoothers();
+}
+
+void LorenzOsc::resetSmoothers()
+{
+    // The smoothers are stepped once per control tick, so their ramp length is
+    // expressed at the control rate rather than at the sample rate.
+    const double controlRate = sampleRate / controlInterval;
+    sigma.reset(controlRate, rampDurationSeconds);
+    rho.reset(controlRate, rampDurationSeconds);
+    beta.reset(controlRate, rampDurationSeconds);
+    mx.reset(controlRate, rampDurationSeconds);
+    my.reset(controlRate, rampDurationSeconds);
+    mz.reset(controlRate, rampDurationSeconds);
+    cx.reset(controlRate, rampDurationSeconds);
+    cy.reset(controlRate, rampDurationSeconds);
+    cz.reset(controlRate, rampDurationSeconds);
+    taming.reset(controlRate, rampDurationSeconds);
+    dt.reset(controlRate, rampDurationSeconds);
+    samplesUntilControlTick = 0;
 }
 
 void LorenzOsc::reset()
@@ -44,166 +54,498 @@ void LorenzOsc::reset()
     vy = 0.0;
     vz = 0.0;
 
+    // Restart the adaptive integrator from a conservative step size.
+    adaptiveStep = 0.001;
+    adaptiveLead = 0.0;
+    previousError = 1.0e-4;
+    fsalValid = false;
+
     // It's crucial to also reset the internal state of the smoothed parameters.
     // updateParameters() snaps them to their target values immediately.
     updateParameters();
 }
 
-void LorenzOsc::setParameters(const std::atomic<float>* newSigma, const std::atomic<float>* newRho, const std::atomic<float>* newBeta,
-                              const std::atomic<float>* newMx, const std::atomic<float>* newMy, const std::atomic<float>* newMz,
-                              const std::atomic<float>* newCx, const std::atomic<float>* newCy, const std::atomic<float>* newCz,
-                              const std::atomic<float>* newTaming)
+void LorenzOsc::setState(const LorenzKernels::State<double>& newState)
 {
-    sigmaParam = newSigma;
-    rhoParam = newRho;
-    betaParam = newBeta;
-    mxParam = newMx;
-    myParam = newMy;
-    mzParam = newMz;
-    cxParam = newCx;
-    cyParam = newCy;
-    czParam = newCz;
-    tamingParam = newTaming;
+    x = newState[0]; y = newState[1]; z = newState[2];
+    vx = newState[3]; vy = newState[4]; vz = newState[5];
+
+    // The adaptive integrator's derivative and dense output belong to the old state
+    fsalValid = false;
+    adaptiveLead = 0.0;
 }
 
-void LorenzOsc::setTimestep(const std::atomic<float>* newDt)
+void LorenzOsc::setParameters(const ParameterSnapshot& parameters)
 {
-    dtParam = newDt;
+    sigma.setTargetValue(parameters.sigma);
+    rho.setTargetValue(parameters.rho);
+    beta.setTargetValue(parameters.beta);
+    mx.setTargetValue(parameters.mx);
+    my.setTargetValue(parameters.my);
+    mz.setTargetValue(parameters.mz);
+    cx.setTargetValue(parameters.cx);
+    cy.setTargetValue(parameters.cy);
+    cz.setTargetValue(parameters.cz);
+    taming.setTargetValue(parameters.taming);
+    dt.setTargetValue(parameters.timestep);
+
+    integrator = static_cast<Integrator>(juce::jlimit(0, 2, parameters.integrator));
+}
+
+void LorenzOsc::setTimestep(float newTimestep)
+{
+    dt.setTargetValue(newTimestep);
 }
 
 void LorenzOsc::updateParameters()
 {
     // This function forces an immediate update of all smoothed parameters,
     // bypassing the ramp. This is crucial when loading a new state.
-    if (sigmaParam) sigma.setCurrentAndTargetValue(sigmaParam->load());
-    if (rhoParam)   rho.setCurrentAndTargetValue(rhoParam->load());
-    if (betaParam)  beta.setCurrentAndTargetValue(betaParam->load());
-    if (mxParam)    mx.setCurrentAndTargetValue(mxParam->load());
-    if (myParam)    my.setCurrentAndTargetValue(myParam->load());
-    if (mzParam)    mz.setCurrentAndTargetValue(mzParam->load());
-    if (cxParam)    cx.setCurrentAndTargetValue(cxParam->load());
-    if (cyParam)    cy.setCurrentAndTargetValue(cyParam->load());
-    if (czParam)    cz.setCurrentAndTargetValue(czParam->load());
-    if (tamingParam) taming.setCurrentAndTargetValue(tamingParam->load());
-    if (dtParam)    dt.setCurrentAndTargetValue(dtParam->load());
+    sigma.setCurrentAndTargetValue(sigma.getTargetValue());
+    rho.setCurrentAndTargetValue(rho.getTargetValue());
+    beta.setCurrentAndTargetValue(beta.getTargetValue());
+    mx.setCurrentAndTargetValue(mx.getTargetValue());
+    my.setCurrentAndTargetValue(my.getTargetValue());
+    mz.setCurrentAndTargetValue(mz.getTargetValue());
+    cx.setCurrentAndTargetValue(cx.getTargetValue());
+    cy.setCurrentAndTargetValue(cy.getTargetValue());
+    cz.setCurrentAndTargetValue(cz.getTargetValue());
+    taming.setCurrentAndTargetValue(taming.getTargetValue());
+    dt.setCurrentAndTargetValue(dt.getTargetValue());
+
+    coefficients = getCurrentCoefficients();
+    timestep = dt.getCurrentValue();
+    ramping = false;
+    coefficientsRamping = false;
 }
 
 void LorenzOsc::setRampLength(double rampLengthSeconds)
 {
     this->rampDurationSeconds = rampLengthSeconds; // 'this->' is good practice here to prevent shadowing
-    sigma.reset(sampleRate, rampDurationSeconds);
-    rho.reset(sampleRate, rampDurationSeconds);
-    beta.reset(sampleRate, rampDurationSeconds);
-    mx.reset(sampleRate, rampDurationSeconds);
-    my.reset(sampleRate, rampDurationSeconds);
-    mz.reset(sampleRate, rampDurationSeconds);
-    cx.reset(sampleRate, rampDurationSeconds);
-    cy.reset(sampleRate, rampDurationSeconds);
-    cz.reset(sampleRate, rampDurationSeconds);
-    taming.reset(sampleRate, rampDurationSeconds);
-    dt.reset(sampleRate, rampDurationSeconds);
-}
-
-std::tuple<double, double, double> LorenzOsc::getNextSample()
-{
-    // Set the target for the smoothed values from the parameters
-    sigma.setTargetValue(sigmaParam->load());
-    rho.setTargetValue(rhoParam->load());
-    beta.setTargetValue(betaParam->load());
-    mx.setTargetValue(mxParam->load());
-    my.setTargetValue(myParam->load());
-    mz.setTargetValue(mzParam->load());
-    cx.setTargetValue(cxParam->load());
-    cy.setTargetValue(cyParam->load());
-    cz.setTargetValue(czParam->load());
-    taming.setTargetValue(tamingParam->load());
-    dt.setTargetValue(dtParam->load());
-    
-    // Get the smoothed parameter values once, before the simulation loop.
-    const float currentSigma  = sigma.getNextValue();
-    const float currentRho    = rho.getNextValue();
-    const float currentBeta   = beta.getNextValue();
-    const float currentMx     = mx.getNextValue();
-    const float currentMy     = my.getNextValue();
-    const float currentMz     = mz.getNextValue();
-    const float currentCx     = cx.getNextValue();
-    const float currentCy     = cy.getNextValue();
-    const float currentCz     = cz.getNextValue();
-    const float currentTaming = taming.getNextValue();
-    const float totalDt       = dt.getNextValue();
-
-    constexpr float maxSimulationTimestep = 0.005f;
+    resetSmoothers();
+}
+
+void LorenzOsc::setControlInterval(int numSamples)
+{
+    controlInterval = std::max(1, numSamples);
+    resetSmoothers();
+}
+
+bool LorenzOsc::isSmoothingCoefficients() const
+{
+    return sigma.isSmoothing() || rho.isSmoothing() || beta.isSmoothing()
+        || mx.isSmoothing() || my.isSmoothing() || mz.isSmoothing()
+        || cx.isSmoothing() || cy.isSmoothing() || cz.isSmoothing()
+        || taming.isSmoothing();
+}
+
+LorenzOsc::Coefficients LorenzOsc::makeModulatedCoefficients(float newSigma, float newRho, float newBeta,
+                                                             float newMx, float newMy, float newMz,
+                                                             float newCx, float newCy, float newCz, float newTaming) const
+{
+    // The offsets keep the targets inside their ranges, but a base value that is
+    // still ramping can be pushed slightly past them: keep the masses positive
+    // and the damping terms non-negative.
+    constexpr float minMass = 1.0e-4f;
+
+    return LorenzKernels::makeCoefficients<double>(newSigma + modulation.sigma,
+                                                   newRho + modulation.rho,
+                                                   newBeta + modulation.beta,
+                                                   juce::jmax(minMass, newMx + modulation.mx),
+                                                   juce::jmax(minMass, newMy + modulation.my),
+                                                   juce::jmax(minMass, newMz + modulation.mz),
+                                                   juce::jmax(0.0f, newCx + modulation.cx),
+                                                   juce::jmax(0.0f, newCy + modulation.cy),
+                                                   juce::jmax(0.0f, newCz + modulation.cz),
+                                                   juce::jmax(0.0f, newTaming + modulation.taming));
+}
+
+LorenzOsc::Coefficients LorenzOsc::getCurrentCoefficients() const
+{
+    return makeModulatedCoefficients(sigma.getCurrentValue(), rho.getCurrentValue(), beta.getCurrentValue(),
+                                     mx.getCurrentValue(), my.getCurrentValue(), mz.getCurrentValue(),
+                                     cx.getCurrentValue(), cy.getCurrentValue(), cz.getCurrentValue(),
+                                     taming.getCurrentValue());
+}
+
+LorenzOsc::Coefficients LorenzOsc::getNextCoefficients()
+{
+    const float currentSigma = sigma.getNextValue();
+    const float currentRho   = rho.getNextValue();
+    const float currentBeta  = beta.getNextValue();
+    const float currentMx    = mx.getNextValue();
+    const float currentMy    = my.getNextValue();
+    const float currentMz    = mz.getNextValue();
+    const float currentCx    = cx.getNextValue();
+    const float currentCy    = cy.getNextValue();
+    const float currentCz    = cz.getNextValue();
+
+    return makeModulatedCoefficients(currentSigma, currentRho, currentBeta,
+                                     currentMx, currentMy, currentMz,
+                                     currentCx, currentCy, currentCz,
+                                     taming.getNextValue());
+}
+
+void LorenzOsc::setModulation(const AttractorOffsets& offsets)
+{
+    modulation = offsets;
+    modulationPending = true;
+}
+
+namespace
+{
+    using LorenzKernels::maxSimulationTimestep;
+
+    // The linearly implicit scheme stays stable with much larger steps, so the
+    // sub-step limit is only there to keep the second-order error in check.
+    constexpr float maxStiffSimulationTimestep = 0.025f;
+
+    // Bounds and tolerances for the adaptive integrator. The output is a float
+    // signal, so there is no point resolving the state much finer than the
+    // output: the absolute tolerance is one 16-bit step at the processor's
+    // X/Y output scale (0.025), i.e. 1 / (32768 * 0.025) in attractor units,
+    // with a relative term for the large excursions.
+    constexpr double adaptiveAbsoluteTolerance = 1.0 / (32768.0 * 0.025);
+    constexpr double adaptiveRelativeTolerance = 1.0e-3;
+    constexpr double minAdaptiveStep = 1.0e-7;
+    constexpr double maxAdaptiveStep = 0.05;
+    constexpr int maxAdaptiveStepsPerSample = 64;
 
     // Determine the number of sub-steps needed to keep the simulation stable.
-    const int numSubSteps = std::max(1, static_cast<int>(std::ceil(totalDt / maxSimulationTimestep)));
-    const float simulationTimestep = totalDt / numSubSteps;
+    inline int getNumSubSteps(float totalDt, float maxTimestep = maxSimulationTimestep)
+    {
+        return std::max(1, static_cast<int>(std::ceil(totalDt / maxTimestep)));
+    }
+}
+
+int LorenzOsc::getSubStepsPerSample(Integrator integrator, float timestep)
+{
+    switch (integrator)
+    {
+        case Integrator::RK4:           return getNumSubSteps(timestep);
+        case Integrator::Rosenbrock:    return getNumSubSteps(timestep, maxStiffSimulationTimestep);
+        case Integrator::DormandPrince: break;
+    }
+
+    return 0;
+}
+
+template <typename Kernel>
+void LorenzOsc::integrateRK4(State& s, const Coefficients& c, double totalDt) const
+{
+    const int numSubSteps = getNumSubSteps(static_cast<float>(totalDt));
+    Kernel::rk4(s, c, totalDt / numSubSteps, numSubSteps);
+}
+
+template <typename Kernel>
+void LorenzOsc::integrateDormandPrince(State& s, const Coefficients& c, double totalDt, double* position)
+{
+    // --- Dormand-Prince RK5(4) with FSAL, step-size control and dense output ---
+    // Steps are as large as the local error estimate allows: long on the smooth
+    // parts of the orbit, short near the fast lobes. They are not tied to the
+    // sample grid: the integrator runs ahead of the output time and each sample
+    // is read from the continuous extension of the last accepted step.
+    static constexpr double a21 = 1.0 / 5.0;
+    static constexpr double a31 = 3.0 / 40.0,       a32 = 9.0 / 40.0;
+    static constexpr double a41 = 44.0 / 45.0,      a42 = -56.0 / 15.0,      a43 = 32.0 / 9.0;
+    static constexpr double a51 = 19372.0 / 6561.0, a52 = -25360.0 / 2187.0, a53 = 64448.0 / 6561.0, a54 = -212.0 / 729.0;
+    static constexpr double a61 = 9017.0 / 3168.0,  a62 = -355.0 / 33.0,     a63 = 46732.0 / 5247.0, a64 = 49.0 / 176.0, a65 = -5103.0 / 18656.0;
+    static constexpr double b1 = 35.0 / 384.0, b3 = 500.0 / 1113.0, b4 = 125.0 / 192.0, b5 = -2187.0 / 6784.0, b6 = 11.0 / 84.0;
+
+    // Difference between the 5th and 4th order weights, used for the error estimate
+    static constexpr double e1 = 71.0 / 57600.0, e3 = -71.0 / 16695.0, e4 = 71.0 / 1920.0,
+                            e5 = -17253.0 / 339200.0, e6 = 22.0 / 525.0, e7 = -1.0 / 40.0;
+
+    // Weights of the fourth-order continuous extension (Hairer & Wanner)
+    static constexpr double d1 = -12715105075.0 / 11282082432.0, d3 = 87487479700.0 / 32700410799.0,
+                            d4 = -10690763975.0 / 1880347072.0,  d5 = 701980252875.0 / 199316789632.0,
+                            d6 = -1453857185.0 / 822651844.0,    d7 = 69997945.0 / 29380423.0;
+
+    State k2, k3, k4, k5, k6, k7, tmp, next;
+    State& k1 = fsalDerivative;
 
-    // Helper lambda to compute derivatives at a given state.
-    // It now captures the pre-calculated smoothed parameter values.
-    auto derivatives = [&](double tX, double tY, double tZ, double tVx, double tVy, double tVz) -> std::tuple<double, double, double, double, double, double>
+    if (! fsalValid)
     {
-        const double dxdt = tVx;
-        const double dydt = tVy;
-        const double dzdt = tVz;
+        Kernel::derivatives(c, s, k1);
+        fsalValid = true;
+    }
+
+    // Time by which the integrator is ahead of the output once this sample is consumed.
+    adaptiveLead -= totalDt;
+
+    int steps = 0;
+
+    while (adaptiveLead < 0.0)
+    {
+        const double h = adaptiveStep;
+
+        for (size_t j = 0; j < s.size(); ++j) tmp[j] = s[j] + h * (a21 * k1[j]);
+        Kernel::derivatives(c, tmp, k2);
+        for (size_t j = 0; j < s.size(); ++j) tmp[j] = s[j] + h * (a31 * k1[j] + a32 * k2[j]);
+        Kernel::derivatives(c, tmp, k3);
+        for (size_t j = 0; j < s.size(); ++j) tmp[j] = s[j] + h * (a41 * k1[j] + a42 * k2[j] + a43 * k3[j]);
+        Kernel::derivatives(c, tmp, k4);
+        for (size_t j = 0; j < s.size(); ++j) tmp[j] = s[j] + h * (a51 * k1[j] + a52 * k2[j] + a53 * k3[j] + a54 * k4[j]);
+        Kernel::derivatives(c, tmp, k5);
+        for (size_t j = 0; j < s.size(); ++j) tmp[j] = s[j] + h * (a61 * k1[j] + a62 * k2[j] + a63 * k3[j] + a64 * k4[j] + a65 * k5[j]);
+        Kernel::derivatives(c, tmp, k6);
+        for (size_t j = 0; j < s.size(); ++j) next[j] = s[j] + h * (b1 * k1[j] + b3 * k3[j] + b4 * k4[j] + b5 * k5[j] + b6 * k6[j]);
+        Kernel::derivatives(c, next, k7);
+
+        // RMS of the error estimate, scaled by the mixed absolute/relative tolerance
+        double errorSum = 0.0;
+        for (size_t j = 0; j < s.size(); ++j)
+        {
+            const double errorEstimate = h * (e1 * k1[j] + e3 * k3[j] + e4 * k4[j] + e5 * k5[j] + e6 * k6[j] + e7 * k7[j]);
+            const double scale = adaptiveAbsoluteTolerance + adaptiveRelativeTolerance * std::max(std::abs(s[j]), std::abs(next[j]));
+            errorSum += (errorEstimate / scale) * (errorEstimate / scale);
+        }
+        const double error = std::sqrt(errorSum / static_cast<double>(s.size()));
+
+        // PI step-size controller (as in Hairer's DOPRI5), limited to a factor of 5 either way.
+        // The memory of the previous error keeps the step from oscillating around
+        // the stability limit on stiff settings.
+        const double clampedError = std::max(error, 1.0e-10);
+        const double factor = juce::jlimit(0.2, 5.0, 0.9 * std::pow(clampedError, -0.17) * std::pow(previousError, 0.04));
+        adaptiveStep = juce::jlimit(minAdaptiveStep, maxAdaptiveStep, h * factor);
+
+        // Give up refining after too many attempts so a single sample can't stall the audio thread.
+        const bool forceAccept = ++steps >= maxAdaptiveStepsPerSample || h <= minAdaptiveStep || ! std::isfinite(error);
+
+        if (error <= 1.0 || forceAccept)
+        {
+            // Build the continuous extension over the accepted step (positions only).
+            for (size_t j = 0; j < 3; ++j)
+            {
+                const double difference = next[j] - s[j];
+                const double slopeStart = h * k1[j] - difference;
+                denseOutput[0][j] = s[j];
+                denseOutput[1][j] = difference;
+                denseOutput[2][j] = slopeStart;
+                denseOutput[3][j] = difference - h * k7[j] - slopeStart;
+                denseOutput[4][j] = h * (d1 * k1[j] + d3 * k3[j] + d4 * k4[j] + d5 * k5[j] + d6 * k6[j] + d7 * k7[j]);
+            }
+
+            s = next;
+            k1 = k7; // First Same As Last
+            previousError = std::max(clampedError, 1.0e-4);
+            denseStep = h;
+            adaptiveLead += h;
+
+            if (forceAccept)
+                adaptiveLead = std::max(adaptiveLead, 0.0);
+        }
+    }
 
-        // Add the non-linear damping term: -taming * v^3. This opposes the velocity.
-        const double tamingForceX = currentTaming * tVx * tVx * tVx;
-        const double tamingForceY = currentTaming * tVy * tVy * tVy;
-        const double tamingForceZ = currentTaming * tVz * tVz * tVz;
+    // Evaluate the continuous extension at the output time.
+    const double theta = 1.0 - adaptiveLead / denseStep;
+    const double theta1 = 1.0 - theta;
 
-        const double dvxdt = (currentSigma * (tY - tX) - currentCx * tVx - tamingForceX) / currentMx;
-        const double dvydt = (tX * (currentRho - tZ) - tY - currentCy * tVy - tamingForceY) / currentMy;
-        const double dvzdt = (tX * tY - currentBeta * tZ - currentCz * tVz - tamingForceZ) / currentMz;
-        return { dxdt, dydt, dzdt, dvxdt, dvydt, dvzdt };
-    };
+    for (size_t j = 0; j < 3; ++j)
+        position[j] = denseOutput[0][j] + theta * (denseOutput[1][j] + theta1 * (denseOutput[2][j] + theta * (denseOutput[3][j] + theta1 * denseOutput[4][j])));
+}
+
+template <typename Kernel>
+void LorenzOsc::integrateRosenbrock(State& s, const Coefficients& c, double totalDt) const
+{
+    // --- Two-stage Rosenbrock method (ROS2, L-stable) ---
+    // Each stage solves (I - gamma * h * J) k = r, with J the analytic Jacobian
+    // at the start of the step. J has the block form [[0, I], [A, D]] where A is
+    // the derivative of the accelerations with respect to the positions and D is
+    // diagonal (damping + taming), so the 6x6 system reduces to a 3x3 one:
+    //   (I - g*D - g^2*A) kv = rv + g*A*rp,   kp = rp + g*kv   (g = gamma * h)
+    static constexpr double gamma = 1.0 + 1.0 / juce::MathConstants<double>::sqrt2;
+
+    const int numSubSteps = getNumSubSteps(static_cast<float>(totalDt), maxStiffSimulationTimestep);
+    const double h = totalDt / numSubSteps;
+    const double g = gamma * h;
+
+    State f0, f1, k1, k2, tmp;
 
     for (int i = 0; i < numSubSteps; ++i)
     {
-        // --- Fourth-Order Runge-Kutta (RK4) Integration for one sub-step ---
-
-        // k1: Evaluate derivatives at the current state
-        auto [k1_x, k1_y, k1_z, k1_vx, k1_vy, k1_vz] = derivatives(x, y, z, vx, vy, vz);
-
-        // k2: Evaluate at midpoint using k1
-        auto [k2_x, k2_y, k2_z, k2_vx, k2_vy, k2_vz] = derivatives(x + 0.5 * simulationTimestep * k1_x,
-                                                                   y + 0.5 * simulationTimestep * k1_y,
-                                                                   z + 0.5 * simulationTimestep * k1_z,
-                                                                   vx + 0.5 * simulationTimestep * k1_vx,
-                                                                   vy + 0.5 * simulationTimestep * k1_vy,
-                                                                   vz + 0.5 * simulationTimestep * k1_vz);
-
-        // k3: Evaluate at midpoint using k2
-        auto [k3_x, k3_y, k3_z, k3_vx, k3_vy, k3_vz] = derivatives(x + 0.5 * simulationTimestep * k2_x,
-                                                                   y + 0.5 * simulationTimestep * k2_y,
-                                                                   z + 0.5 * simulationTimestep * k2_z,
-                                                                   vx + 0.5 * simulationTimestep * k2_vx,
-                                                                   vy + 0.5 * simulationTimestep * k2_vy,
-                                                                   vz + 0.5 * simulationTimestep * k2_vz);
-
-        // k4: Evaluate at the end of the step using k3
-        auto [k4_x, k4_y, k4_z, k4_vx, k4_vy, k4_vz] = derivatives(x + simulationTimestep * k3_x,
-                                                                   y + simulationTimestep * k3_y,
-                                                                   z + simulationTimestep * k3_z,
-                                                                   vx + simulationTimestep * k3_vx,
-                                                                   vy + simulationTimestep * k3_vy,
-                                                                   vz + simulationTimestep * k3_vz);
-
-        // Update state using the weighted average of the k-values
-        x += (simulationTimestep / 6.0) * (k1_x + 2.0 * k2_x + 2.0 * k3_x + k4_x);
-        y += (simulationTimestep / 6.0) * (k1_y + 2.0 * k2_y + 2.0 * k3_y + k4_y);
-        z += (simulationTimestep / 6.0) * (k1_z + 2.0 * k2_z + 2.0 * k3_z + k4_z);
-        vx += (simulationTimestep / 6.0) * (k1_vx + 2.0 * k2_vx + 2.0 * k3_vx + k4_vx);
-        vy += (simulationTimestep / 6.0) * (k1_vy + 2.0 * k2_vy + 2.0 * k3_vy + k4_vy);
-        vz += (simulationTimestep / 6.0) * (k1_vz + 2.0 * k2_vz + 2.0 * k3_vz + k4_vz);
+        const double tX = s[0], tY = s[1], tZ = s[2];
+        const double tVx = s[3], tVy = s[4], tVz = s[5];
+
+        // Position block A (rows: accelerations x, y, z)
+        const double a[3][3] = { { -c.sigma * c.invMx,     c.sigma * c.invMx, 0.0 },
+                                 { (c.rho - tZ) * c.invMy, -c.invMy,          -tX * c.invMy },
+                                 { tY * c.invMz,           tX * c.invMz,      -c.beta * c.invMz } };
+
+        // Diagonal velocity block D
+        const double d[3] = { -(c.cx + 3.0 * c.taming * tVx * tVx) * c.invMx,
+                              -(c.cy + 3.0 * c.taming * tVy * tVy) * c.invMy,
+                              -(c.cz + 3.0 * c.taming * tVz * tVz) * c.invMz };
+
+        // M = I - g*D - g^2*A, inverted once per step through its adjugate.
+        double m[3][3];
+        for (int r = 0; r < 3; ++r)
+            for (int col = 0; col < 3; ++col)
+                m[r][col] = (r == col ? 1.0 - g * d[r] : 0.0) - g * g * a[r][col];
+
+        const double inv[3][3] = { { m[1][1] * m[2][2] - m[1][2] * m[2][1], m[0][2] * m[2][1] - m[0][1] * m[2][2], m[0][1] * m[1][2] - m[0][2] * m[1][1] },
+                                   { m[1][2] * m[2][0] - m[1][0] * m[2][2], m[0][0] * m[2][2] - m[0][2] * m[2][0], m[0][2] * m[1][0] - m[0][0] * m[1][2] },
+                                   { m[1][0] * m[2][1] - m[1][1] * m[2][0], m[0][1] * m[2][0] - m[0][0] * m[2][1], m[0][0] * m[1][1] - m[0][1] * m[1][0] } };
+        const double determinant = m[0][0] * inv[0][0] + m[0][1] * inv[1][0] + m[0][2] * inv[2][0];
+        const double invDeterminant = 1.0 / determinant;
+
+        auto solve = [&](const State& r, State& k)
+        {
+            double rhs[3];
+            for (int row = 0; row < 3; ++row)
+                rhs[row] = r[3 + row] + g * (a[row][0] * r[0] + a[row][1] * r[1] + a[row][2] * r[2]);
+
+            for (int row = 0; row < 3; ++row)
+            {
+                k[3 + row] = invDeterminant * (inv[row][0] * rhs[0] + inv[row][1] * rhs[1] + inv[row][2] * rhs[2]);
+                k[row] = r[row] + g * k[3 + row];
+            }
+        };
+
+        // Stage 1
+        Kernel::derivatives(c, s, f0);
+        solve(f0, k1);
+
+        // Stage 2
+        for (size_t j = 0; j < s.size(); ++j) tmp[j] = s[j] + h * k1[j];
+        Kernel::derivatives(c, tmp, f1);
+        for (size_t j = 0; j < s.size(); ++j) f1[j] -= 2.0 * k1[j];
+        solve(f1, k2);
+
+        for (size_t j = 0; j < s.size(); ++j)
+            s[j] += h * (1.5 * k1[j] + 0.5 * k2[j]);
+    }
+}
+
+void LorenzOsc::renderBlock(float* xOut, float* yOut, float* zOut, int numSamples)
+{
+    // Pick the derivative kernel for this block. Both ends of any ramp, the
+    // coefficients currently held and the modulation must agree, so the choice
+    // holds for every sample of the block.
+    const bool tamed = taming.getCurrentValue() != 0.0f || taming.getTargetValue() != 0.0f
+                    || modulation.taming != 0.0f || coefficients.taming != 0.0;
+    const bool uniformMass = mx.getCurrentValue() == my.getCurrentValue() && mx.getCurrentValue() == mz.getCurrentValue()
+                          && mx.getTargetValue() == my.getTargetValue() && mx.getTargetValue() == mz.getTargetValue()
+                          && modulation.mx == modulation.my && modulation.mx == modulation.mz
+                          && coefficients.invMx == coefficients.invMy && coefficients.invMx == coefficients.invMz;
+
+    if (tamed)
+    {
+        if (uniformMass) renderBlockWithKernel<LorenzKernels::Kernel<true, true>>(xOut, yOut, zOut, numSamples, integrator);
+        else             renderBlockWithKernel<LorenzKernels::Kernel<true, false>>(xOut, yOut, zOut, numSamples, integrator);
     }
+    else
+    {
+        if (uniformMass) renderBlockWithKernel<LorenzKernels::Kernel<false, true>>(xOut, yOut, zOut, numSamples, integrator);
+        else             renderBlockWithKernel<LorenzKernels::Kernel<false, false>>(xOut, yOut, zOut, numSamples, integrator);
+    }
+}
+
+template <typename Kernel>
+void LorenzOsc::renderBlockWithKernel(float* xOut, float* yOut, float* zOut, int numSamples, Integrator integrator)
+{
+    // Work on a local copy of the state so the integration loop stays in registers.
+    State s { x, y, z, vx, vy, vz };
+
+    int n = 0;
 
-    // --- Stability Check ---
-    // If any state variable becomes non-finite, reset the system.
-    if (! (std::isfinite(x) && std::isfinite(y) && std::isfinite(z)))
+    while (n < numSamples)
     {
-        reset();
+        // --- Control tick ---
+        // The smoothed parameters only advance here. The coefficients then ramp
+        // linearly towards the new values over the next controlInterval samples.
+        // New modulation offsets start a tick straight away.
+        if (samplesUntilControlTick <= 0 || modulationPending)
+        {
+            samplesUntilControlTick = controlInterval;
+            const bool smoothing = isSmoothingCoefficients();
+            coefficientsRamping = smoothing || modulationPending;
+            ramping = coefficientsRamping || dt.isSmoothing();
+            modulationPending = false;
+
+            if (ramping)
+            {
+                const Coefficients target = smoothing ? getNextCoefficients() : getCurrentCoefficients();
+                const double targetTimestep = dt.isSmoothing() ? dt.getNextValue() : dt.getCurrentValue();
+                timestepIncrement = (targetTimestep - timestep) / controlInterval;
+
+                // The PID ramps the timestep almost all the time. When nothing
+                // else moves, the coefficients hold still, so the adaptive
+                // integrator's stored derivative stays valid.
+                if (coefficientsRamping)
+                    coefficientIncrement = LorenzKernels::rampIncrement(coefficients, target, controlInterval);
+                else
+                    coefficients = target;
+            }
+            else
+            {
+                // Land exactly on the final values once the ramp is over.
+                coefficients = getCurrentCoefficients();
+                timestep = dt.getCurrentValue();
+            }
+        }
+
+        const int subBlockEnd = std::min(numSamples, n + samplesUntilControlTick);
+        samplesUntilControlTick -= subBlockEnd - n;
+
+        Coefficients c = coefficients;
+        double totalDt = timestep;
+
+        for (; n < subBlockEnd; ++n)
+        {
+            if (ramping)
+            {
+                totalDt += timestepIncrement;
+
+                if (coefficientsRamping)
+                {
+                    LorenzKernels::advance(c, coefficientIncrement);
+
+                    // The stored derivative was computed with the previous coefficients.
+                    fsalValid = false;
+                }
+            }
+
+            double position[3];
+
+            if (integrator == Integrator::DormandPrince)
+            {
+                integrateDormandPrince<Kernel>(s, c, totalDt, position);
+            }
+            else
+            {
+                if (integrator == Integrator::Rosenbrock)
+                    integrateRosenbrock<Kernel>(s, c, totalDt);
+                else
+                    integrateRK4<Kernel>(s, c, totalDt);
+
+                std::copy(s.begin(), s.begin() + 3, position);
+                fsalValid = false;
+                adaptiveLead = 0.0;
+            }
+
+            // --- Stability Check ---
+            // If any state variable becomes non-finite, reset the system.
+            if (! (std::isfinite(position[0]) && std::isfinite(position[1]) && std::isfinite(position[2])
+                   && std::isfinite(s[0]) && std::isfinite(s[1]) && std::isfinite(s[2])))
+            {
+                reset();
+                s = { x, y, z, vx, vy, vz };
+                c = coefficients;
+                totalDt = timestep;
+                std::copy(s.begin(), s.begin() + 3, position);
+            }
+
+            // The raw values are returned. Scaling will be handled by the processor.
+            xOut[n] = static_cast<float>(position[0]);
+            yOut[n] = static_cast<float>(position[1]);
+            zOut[n] = static_cast<float>(position[2]);
+        }
+
+        coefficients = c;
+        timestep = totalDt;
     }
 
-    // The raw values are returned. Scaling will be handled by the processor.
-    return { x, y, z };
+    x = s[0]; y = s[1]; z = s[2];
+    vx = s[3]; vy = s[4]; vz = s[5];
 }
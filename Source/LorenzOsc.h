@@ -11,6 +11,8 @@
 #pragma once
 
 #include <JuceHeader.h>
+#include "LorenzKernels.h"
+#include "ParameterSnapshot.h"
 
 /**
  * Implements a Lorenz attractor oscillator.
@@ -20,21 +22,91 @@
 class LorenzOsc
 {
 public:
+    /** The numerical schemes available to advance the attractor. */
+    enum class Integrator
+    {
+        RK4,            // Fixed-step fourth-order Runge-Kutta
+        DormandPrince,  // Adaptive, error-controlled RK45
+        Rosenbrock      // Linearly implicit ROS2, for stiff (low mass, high damping) settings
+    };
+
     LorenzOsc();
 
     void prepareToPlay(double sampleRate);
-    std::tuple<double, double, double> getNextSample();
+
+    /**
+     * Renders a block of raw (unscaled) state variables into three separate arrays.
+     * Parameter targets are set once per block by setParameters() and the smoothed values only
+     * advance once per control tick, so between ticks the integration loop only
+     * touches local state and pre-computed coefficients.
+     */
+    void renderBlock(float* xOut, float* yOut, float* zOut, int numSamples);
 
     void reset();
-    void setParameters(const std::atomic<float>* newSigma, const std::atomic<float>* newRho, const std::atomic<float>* newBeta,
-                       const std::atomic<float>* newMx, const std::atomic<float>* newMy, const std::atomic<float>* newMz, //
-                       const std::atomic<float>* newCx, const std::atomic<float>* newCy, const std::atomic<float>* newCz, //
-                       const std::atomic<float>* newTaming); //
-    void setTimestep(const std::atomic<float>* newDt);
+
+    /** The attractor state: x, y, z and their velocities. */
+    LorenzKernels::State<double> getState() const { return { x, y, z, vx, vy, vz }; }
+
+    /** Moves the attractor to the given state, e.g. to carry it over from another oscillator. */
+    void setState(const LorenzKernels::State<double>& newState);
+
+    /** Sets the targets of the attractor parameters and the integrator from the block's snapshot. */
+    void setParameters(const ParameterSnapshot& parameters);
+
+    /**
+     * Sets the target timestep directly, e.g. from the pitch controller between
+     * two segments of a block. It ramps like the other parameters.
+     */
+    void setTimestep(float newTimestep);
+
+    /** The timestep the last rendered sample was integrated with. It lags the target while it ramps. */
+    float getTimestep() const { return static_cast<float>(timestep); }
+
+    /** Snaps every smoothed parameter to its target, bypassing the ramp. */
     void updateParameters();
     void setRampLength(double rampLengthSeconds);
 
+    /** Sets the number of samples between two updates of the smoothed parameters. */
+    void setControlInterval(int numSamples);
+
+    /**
+     * Sets the modulation offsets added to the smoothed attractor parameters.
+     * The coefficients ramp to the modulated values over the next control tick,
+     * which starts with the next rendered sample.
+     */
+    void setModulation(const AttractorOffsets& offsets);
+
+    /** Sub-steps per sample a fixed-step integrator takes at a timestep; 0 for the adaptive one. */
+    static int getSubStepsPerSample(Integrator integrator, float timestep);
+
 private:
+    // Parameter values used by the integrator for one sample (or a whole block when nothing ramps).
+    // Masses are stored as reciprocals so the integration loops never divide.
+    using Coefficients = LorenzKernels::Coefficients<double>;
+
+    // State vector: x, y, z, vx, vy, vz
+    using State = LorenzKernels::State<double>;
+
+    Coefficients getNextCoefficients();
+    Coefficients getCurrentCoefficients() const;
+    Coefficients makeModulatedCoefficients(float newSigma, float newRho, float newBeta,
+                                           float newMx, float newMy, float newMz,
+                                           float newCx, float newCy, float newCz, float newTaming) const;
+    bool isSmoothingCoefficients() const;
+    void resetSmoothers();
+
+    // The sample loop, instantiated once per derivative kernel. The kernel is
+    // picked once per block from the current parameters.
+    template <typename Kernel>
+    void renderBlockWithKernel(float* xOut, float* yOut, float* zOut, int numSamples, Integrator integrator);
+
+    template <typename Kernel>
+    void integrateRK4(State& s, const Coefficients& c, double totalDt) const;
+    template <typename Kernel>
+    void integrateDormandPrince(State& s, const Coefficients& c, double totalDt, double* position);
+    template <typename Kernel>
+    void integrateRosenbrock(State& s, const Coefficients& c, double totalDt) const;
+
     // Lorenz system state
     double x, y, z, vx, vy, vz;
 
@@ -51,12 +123,36 @@ private:
     // Timestep for numerical integration
     juce::SmoothedValue<float> dt;
 
-    // Raw pointers to APVTS parameters
-    const std::atomic<float>* sigmaParam { nullptr }, *rhoParam { nullptr }, *betaParam { nullptr };
-    const std::atomic<float>* mxParam { nullptr }, *myParam { nullptr }, *mzParam { nullptr };
-    const std::atomic<float>* cxParam { nullptr }, *cyParam { nullptr }, *czParam { nullptr };
-    const std::atomic<float>* dtParam { nullptr };
-    const std::atomic<float>* tamingParam { nullptr };
+    // Control-rate state: the smoothers above advance once every controlInterval
+    // samples and the coefficients are interpolated linearly in between. When
+    // nothing ramps the increments are not applied at all.
+    int controlInterval = 32;
+    int samplesUntilControlTick = 0;
+    bool ramping = false;
+    bool coefficientsRamping = false; // False while only the timestep ramps
+    Coefficients coefficients {};
+    Coefficients coefficientIncrement {};
+    double timestep = 0.0;
+    double timestepIncrement = 0.0;
+
+    // Modulation offsets, applied on top of the smoothed parameters at each control tick
+    AttractorOffsets modulation {};
+    bool modulationPending = false;
+
+    // Adaptive integrator state, carried from one sample to the next.
+    // The integrator runs up to one step ahead of the output (adaptiveLead, in
+    // simulation time) and the outputs are interpolated from the dense output
+    // coefficients of the last accepted step.
+    double adaptiveStep;
+    double adaptiveLead;
+    double previousError;
+    double denseStep { 1.0 };
+    double denseOutput[5][3] {};
+    State fsalDerivative {};
+    bool fsalValid { false };
+
+    // Integrator selected by the last snapshot
+    Integrator integrator { Integrator::RK4 };
 
     // Sample rate
     double sampleRate;
@@ -0,0 +1,457 @@
+/*
+  ==============================================================================
+
+    LorenzOscBank.h
+    Created: 16 Oct 2026 10:00:00am
+    Author:  Olivier Doaré
+
+  ==============================================================================
+*/
+
+#pragma once
+
+#include <JuceHeader.h>
+#include "LorenzKernels.h"
+#include "ParameterSnapshot.h"
+
+/**
+ * NumLanes independent Lorenz attractors integrated together with RK4.
+ *
+ * The state and the coefficients are stored lane-interleaved: one array of
+ * NumLanes values per variable. Every stage of the step is a loop over the
+ * lanes with no branch, so the compiler turns it into SSE, AVX or NEON code
+ * and all the lanes advance for about the cost of one.
+ *
+ * Each lane has its own timestep, and so its own number of sub-steps. The bank
+ * runs as many sub-steps as the lane that needs the most; for the other lanes
+ * the extra sub-steps have a zero step length, which leaves their state
+ * untouched. Inactive lanes are masked the same way and keep their state.
+ *
+ * The attractor parameters and the modulation are shared by all the lanes,
+ * and ramp at the control rate as in LorenzOsc. Each lane can add its own
+ * fixed offsets to them.
+ */
+template <int NumLanes>
+class LorenzOscBank
+{
+public:
+    static constexpr int numLanes = NumLanes;
+    using State = LorenzKernels::State<double>;
+
+    LorenzOscBank()
+    {
+        setParameters(ParameterSnapshot {});
+
+        for (int lane = 0; lane < NumLanes; ++lane)
+        {
+            laneTimesteps[(size_t) lane].setCurrentAndTargetValue(ParameterSnapshot {}.timestep);
+            resetLane(lane);
+        }
+
+        resetSmoothers();
+        updateParameters();
+    }
+
+    void prepareToPlay(double newSampleRate)
+    {
+        sampleRate = newSampleRate;
+        resetSmoothers();
+    }
+
+    /** Sets the number of samples between two updates of the smoothed parameters. */
+    void setControlInterval(int numSamples)
+    {
+        controlInterval = std::max(1, numSamples);
+        resetSmoothers();
+    }
+
+    /** Sets the targets of the shared attractor parameters. The timesteps are set per lane. */
+    void setParameters(const ParameterSnapshot& parameters)
+    {
+        sigma.setTargetValue(parameters.sigma);
+        rho.setTargetValue(parameters.rho);
+        beta.setTargetValue(parameters.beta);
+        mx.setTargetValue(parameters.mx);
+        my.setTargetValue(parameters.my);
+        mz.setTargetValue(parameters.mz);
+        cx.setTargetValue(parameters.cx);
+        cy.setTargetValue(parameters.cy);
+        cz.setTargetValue(parameters.cz);
+        taming.setTargetValue(parameters.taming);
+    }
+
+    /** Sets the modulation offsets of every lane. They take effect over the next control tick. */
+    void setModulation(const AttractorOffsets& offsets)
+    {
+        modulation = offsets;
+        offsetsPending = true;
+    }
+
+    /** Sets offsets added to the shared parameters for one lane only. */
+    void setLaneOffsets(int lane, const AttractorOffsets& offsets)
+    {
+        laneOffsets[(size_t) lane] = offsets;
+        offsetsPending = true;
+    }
+
+    /** Sets the target timestep of one lane. It ramps like the other parameters. */
+    void setTimestep(int lane, float newTimestep)
+    {
+        laneTimesteps[(size_t) lane].setTargetValue(newTimestep);
+    }
+
+    /** An inactive lane is not integrated and not written by renderBlock(); it keeps its state. */
+    void setActive(int lane, bool shouldBeActive) { active[(size_t) lane] = shouldBeActive; }
+    bool isActive(int lane) const { return active[(size_t) lane]; }
+
+    /** Puts one lane back to the initial state, with its timestep snapped to its target. */
+    void resetLane(int lane)
+    {
+        setState(lane, LorenzKernels::initialState<double>);
+
+        auto& laneTimestep = laneTimesteps[(size_t) lane];
+        laneTimestep.setCurrentAndTargetValue(laneTimestep.getTargetValue());
+        timesteps[(size_t) lane] = laneTimestep.getCurrentValue();
+        timestepIncrements[(size_t) lane] = 0.0;
+    }
+
+    State getState(int lane) const
+    {
+        State laneState;
+        for (size_t j = 0; j < laneState.size(); ++j)
+            laneState[j] = state[j][(size_t) lane];
+        return laneState;
+    }
+
+    void setState(int lane, const State& newState)
+    {
+        for (size_t j = 0; j < newState.size(); ++j)
+            state[j][(size_t) lane] = newState[j];
+    }
+
+    /** Snaps every smoothed parameter and timestep to its target, bypassing the ramp. */
+    void updateParameters()
+    {
+        for (auto* smoother : { &sigma, &rho, &beta, &mx, &my, &mz, &cx, &cy, &cz, &taming })
+            smoother->setCurrentAndTargetValue(smoother->getTargetValue());
+
+        for (int lane = 0; lane < NumLanes; ++lane)
+        {
+            auto& laneTimestep = laneTimesteps[(size_t) lane];
+            laneTimestep.setCurrentAndTargetValue(laneTimestep.getTargetValue());
+            timesteps[(size_t) lane] = laneTimestep.getCurrentValue();
+        }
+
+        coefficients = getLaneCoefficients(false);
+        ramping = false;
+        offsetsPending = false;
+    }
+
+    /**
+     * Renders numSamples of raw x, y and z for every active lane. The output
+     * arrays hold one pointer per lane; the pointers of inactive lanes are not used.
+     */
+    void renderBlock(float* const* xOut, float* const* yOut, float* const* zOut, int numSamples)
+    {
+        // As in LorenzOsc, the taming terms are only computed when some lane needs them.
+        bool tamed = taming.getCurrentValue() != 0.0f || taming.getTargetValue() != 0.0f || modulation.taming != 0.0f;
+        for (int lane = 0; lane < NumLanes; ++lane)
+            tamed = tamed || laneOffsets[(size_t) lane].taming != 0.0f || coefficients.taming[(size_t) lane] != 0.0;
+
+        if (tamed)
+            renderBlockWithKernel<true>(xOut, yOut, zOut, numSamples);
+        else
+            renderBlockWithKernel<false>(xOut, yOut, zOut, numSamples);
+    }
+
+private:
+    using Lanes = std::array<double, NumLanes>;
+
+    struct LaneCoefficients
+    {
+        Lanes sigma, rho, beta;
+        Lanes invMx, invMy, invMz;
+        Lanes cx, cy, cz;
+        Lanes taming;
+    };
+
+    using LaneState = std::array<Lanes, 6>;
+
+    void resetSmoothers()
+    {
+        // Stepped once per control tick, like the smoothers of LorenzOsc
+        const double controlRate = sampleRate / controlInterval;
+
+        for (auto* smoother : { &sigma, &rho, &beta, &mx, &my, &mz, &cx, &cy, &cz, &taming })
+            smoother->reset(controlRate, rampDurationSeconds);
+
+        for (auto& laneTimestep : laneTimesteps)
+            laneTimestep.reset(controlRate, rampDurationSeconds);
+
+        samplesUntilControlTick = 0;
+    }
+
+    bool isSmoothing() const
+    {
+        bool smoothing = sigma.isSmoothing() || rho.isSmoothing() || beta.isSmoothing()
+                      || mx.isSmoothing() || my.isSmoothing() || mz.isSmoothing()
+                      || cx.isSmoothing() || cy.isSmoothing() || cz.isSmoothing()
+                      || taming.isSmoothing();
+
+        for (const auto& laneTimestep : laneTimesteps)
+            smoothing = smoothing || laneTimestep.isSmoothing();
+
+        return smoothing;
+    }
+
+    /** Coefficients of every lane, from the current or the next values of the shared smoothers. */
+    LaneCoefficients getLaneCoefficients(bool advance)
+    {
+        const auto next = [advance] (juce::SmoothedValue<float>& smoother)
+        {
+            return advance ? smoother.getNextValue() : smoother.getCurrentValue();
+        };
+
+        const float baseSigma = next(sigma), baseRho = next(rho), baseBeta = next(beta);
+        const float baseMx = next(mx), baseMy = next(my), baseMz = next(mz);
+        const float baseCx = next(cx), baseCy = next(cy), baseCz = next(cz);
+        const float baseTaming = next(taming);
+
+        // Same limits as LorenzOsc::makeModulatedCoefficients()
+        constexpr float minMass = 1.0e-4f;
+
+        LaneCoefficients c;
+
+        for (size_t lane = 0; lane < (size_t) NumLanes; ++lane)
+        {
+            const auto& offsets = laneOffsets[lane];
+
+            c.sigma[lane] = baseSigma + modulation.sigma + offsets.sigma;
+            c.rho[lane]   = baseRho + modulation.rho + offsets.rho;
+            c.beta[lane]  = baseBeta + modulation.beta + offsets.beta;
+            c.invMx[lane] = 1.0 / juce::jmax(minMass, baseMx + modulation.mx + offsets.mx);
+            c.invMy[lane] = 1.0 / juce::jmax(minMass, baseMy + modulation.my + offsets.my);
+            c.invMz[lane] = 1.0 / juce::jmax(minMass, baseMz + modulation.mz + offsets.mz);
+            c.cx[lane]    = juce::jmax(0.0f, baseCx + modulation.cx + offsets.cx);
+            c.cy[lane]    = juce::jmax(0.0f, baseCy + modulation.cy + offsets.cy);
+            c.cz[lane]    = juce::jmax(0.0f, baseCz + modulation.cz + offsets.cz);
+            c.taming[lane] = juce::jmax(0.0f, baseTaming + modulation.taming + offsets.taming);
+        }
+
+        return c;
+    }
+
+    /** Per-sample increments that take the coefficients from one set to another in numSteps samples. */
+    static LaneCoefficients rampIncrement(const LaneCoefficients& from, const LaneCoefficients& to, int numSteps) noexcept
+    {
+        const double k = 1.0 / numSteps;
+        LaneCoefficients increment;
+
+        for (size_t lane = 0; lane < (size_t) NumLanes; ++lane)
+        {
+            increment.sigma[lane] = (to.sigma[lane] - from.sigma[lane]) * k;
+            increment.rho[lane]   = (to.rho[lane] - from.rho[lane]) * k;
+            increment.beta[lane]  = (to.beta[lane] - from.beta[lane]) * k;
+            increment.invMx[lane] = (to.invMx[lane] - from.invMx[lane]) * k;
+            increment.invMy[lane] = (to.invMy[lane] - from.invMy[lane]) * k;
+            increment.invMz[lane] = (to.invMz[lane] - from.invMz[lane]) * k;
+            increment.cx[lane]    = (to.cx[lane] - from.cx[lane]) * k;
+            increment.cy[lane]    = (to.cy[lane] - from.cy[lane]) * k;
+            increment.cz[lane]    = (to.cz[lane] - from.cz[lane]) * k;
+            increment.taming[lane] = (to.taming[lane] - from.taming[lane]) * k;
+        }
+
+        return increment;
+    }
+
+    static void advance(LaneCoefficients& c, const LaneCoefficients& increment) noexcept
+    {
+        for (size_t lane = 0; lane < (size_t) NumLanes; ++lane)
+        {
+            c.sigma[lane] += increment.sigma[lane];   c.rho[lane] += increment.rho[lane];     c.beta[lane] += increment.beta[lane];
+            c.invMx[lane] += increment.invMx[lane];   c.invMy[lane] += increment.invMy[lane]; c.invMz[lane] += increment.invMz[lane];
+            c.cx[lane] += increment.cx[lane];         c.cy[lane] += increment.cy[lane];       c.cz[lane] += increment.cz[lane];
+            c.taming[lane] += increment.taming[lane];
+        }
+    }
+
+    /**
+     * Time derivative of every lane's state, with the same kernel as LorenzOsc.
+     * The masses differ between lanes once they have offsets, so there is no
+     * uniform-mass shortcut. The kernel inlines to plain arithmetic on each
+     * lane's values, so the loop over the lanes stays branch-free.
+     */
+    template <bool Tamed>
+    static inline void derivatives(const LaneCoefficients& c, const LaneState& s, LaneState& d) noexcept
+    {
+        using Kernel = LorenzKernels::Kernel<Tamed, false>;
+
+        for (size_t lane = 0; lane < (size_t) NumLanes; ++lane)
+        {
+            const typename Kernel::Coeffs laneCoefficients { c.sigma[lane], c.rho[lane], c.beta[lane],
+                                                             c.invMx[lane], c.invMy[lane], c.invMz[lane],
+                                                             c.cx[lane], c.cy[lane], c.cz[lane],
+                                                             c.taming[lane] };
+
+            d[0][lane] = s[3][lane];
+            d[1][lane] = s[4][lane];
+            d[2][lane] = s[5][lane];
+            Kernel::accelerations(laneCoefficients, s[0][lane], s[1][lane], s[2][lane], s[3][lane], s[4][lane], s[5][lane],
+                                  d[3][lane], d[4][lane], d[5][lane]);
+        }
+    }
+
+    /**
+     * Advances every active lane by one sample of its own timestep. A lane
+     * whose sub-steps are done, or an inactive one, takes zero-length steps.
+     */
+    template <bool Tamed>
+    inline void step(const LaneCoefficients& c, const Lanes& totalDt) noexcept
+    {
+        std::array<int, NumLanes> numSubSteps;
+        Lanes h;
+        int maxSubSteps = 0;
+
+        for (size_t lane = 0; lane < (size_t) NumLanes; ++lane)
+        {
+            numSubSteps[lane] = active[lane] ? std::max(1, static_cast<int>(std::ceil(totalDt[lane] / LorenzKernels::maxSimulationTimestep))) : 0;
+            h[lane] = totalDt[lane] / std::max(1, numSubSteps[lane]);
+            maxSubSteps = std::max(maxSubSteps, numSubSteps[lane]);
+        }
+
+        LaneState k1, k2, k3, k4, tmp;
+
+        for (int i = 0; i < maxSubSteps; ++i)
+        {
+            Lanes stepLength, halfStep, sixthStep;
+
+            for (size_t lane = 0; lane < (size_t) NumLanes; ++lane)
+            {
+                stepLength[lane] = i < numSubSteps[lane] ? h[lane] : 0.0;
+                halfStep[lane] = 0.5 * stepLength[lane];
+                sixthStep[lane] = stepLength[lane] * (1.0 / 6.0);
+            }
+
+            derivatives<Tamed>(c, state, k1);
+
+            for (size_t j = 0; j < 6; ++j)
+                for (size_t lane = 0; lane < (size_t) NumLanes; ++lane)
+                    tmp[j][lane] = state[j][lane] + halfStep[lane] * k1[j][lane];
+            derivatives<Tamed>(c, tmp, k2);
+
+            for (size_t j = 0; j < 6; ++j)
+                for (size_t lane = 0; lane < (size_t) NumLanes; ++lane)
+                    tmp[j][lane] = state[j][lane] + halfStep[lane] * k2[j][lane];
+            derivatives<Tamed>(c, tmp, k3);
+
+            for (size_t j = 0; j < 6; ++j)
+                for (size_t lane = 0; lane < (size_t) NumLanes; ++lane)
+                    tmp[j][lane] = state[j][lane] + stepLength[lane] * k3[j][lane];
+            derivatives<Tamed>(c, tmp, k4);
+
+            for (size_t j = 0; j < 6; ++j)
+                for (size_t lane = 0; lane < (size_t) NumLanes; ++lane)
+                    state[j][lane] += sixthStep[lane] * (k1[j][lane] + 2.0 * k2[j][lane] + 2.0 * k3[j][lane] + k4[j][lane]);
+        }
+    }
+
+    template <bool Tamed>
+    void renderBlockWithKernel(float* const* xOut, float* const* yOut, float* const* zOut, int numSamples)
+    {
+        int n = 0;
+
+        while (n < numSamples)
+        {
+            // --- Control tick ---
+            // Same scheme as LorenzOsc: the smoothers advance here and the
+            // coefficients and timesteps ramp linearly until the next tick.
+            if (samplesUntilControlTick <= 0 || offsetsPending)
+            {
+                samplesUntilControlTick = controlInterval;
+                const bool smoothing = isSmoothing();
+                ramping = smoothing || offsetsPending;
+                offsetsPending = false;
+
+                if (ramping)
+                {
+                    coefficientIncrement = rampIncrement(coefficients, getLaneCoefficients(smoothing), controlInterval);
+
+                    for (size_t lane = 0; lane < (size_t) NumLanes; ++lane)
+                    {
+                        auto& laneTimestep = laneTimesteps[lane];
+                        const double target = smoothing ? laneTimestep.getNextValue() : laneTimestep.getCurrentValue();
+                        timestepIncrements[lane] = (target - timesteps[lane]) / controlInterval;
+                    }
+                }
+                else
+                {
+                    coefficients = getLaneCoefficients(false);
+
+                    for (size_t lane = 0; lane < (size_t) NumLanes; ++lane)
+                        timesteps[lane] = laneTimesteps[lane].getCurrentValue();
+                }
+            }
+
+            const int subBlockEnd = std::min(numSamples, n + samplesUntilControlTick);
+            samplesUntilControlTick -= subBlockEnd - n;
+
+            for (; n < subBlockEnd; ++n)
+            {
+                if (ramping)
+                {
+                    advance(coefficients, coefficientIncrement);
+
+                    for (size_t lane = 0; lane < (size_t) NumLanes; ++lane)
+                        timesteps[lane] += timestepIncrements[lane];
+                }
+
+                step<Tamed>(coefficients, timesteps);
+
+                for (int lane = 0; lane < NumLanes; ++lane)
+                {
+                    if (! active[(size_t) lane])
+                        continue;
+
+                    // --- Stability Check ---
+                    // A lane that blows up starts over on its own; the others go on.
+                    if (! (std::isfinite(state[0][(size_t) lane]) && std::isfinite(state[1][(size_t) lane])
+                           && std::isfinite(state[2][(size_t) lane])))
+                        setState(lane, LorenzKernels::initialState<double>);
+
+                    xOut[lane][n] = static_cast<float>(state[0][(size_t) lane]);
+                    yOut[lane][n] = static_cast<float>(state[1][(size_t) lane]);
+                    zOut[lane][n] = static_cast<float>(state[2][(size_t) lane]);
+                }
+            }
+        }
+    }
+
+    // Lane-interleaved state: x, y, z, vx, vy, vz, one value per lane each
+    alignas(64) LaneState state {};
+
+    // Shared attractor parameters and modulation, with per-lane offsets on top
+    juce::SmoothedValue<float> sigma, rho, beta;
+    juce::SmoothedValue<float> mx, my, mz;
+    juce::SmoothedValue<float> cx, cy, cz;
+    juce::SmoothedValue<float> taming;
+    AttractorOffsets modulation {};
+    std::array<AttractorOffsets, NumLanes> laneOffsets {};
+    bool offsetsPending = false;
+
+    // Per-lane timesteps
+    std::array<juce::SmoothedValue<float>, NumLanes> laneTimesteps;
+    alignas(64) Lanes timesteps {};
+    alignas(64) Lanes timestepIncrements {};
+
+    // Control-rate ramp of the coefficients, as in LorenzOsc
+    alignas(64) LaneCoefficients coefficients {};
+    alignas(64) LaneCoefficients coefficientIncrement {};
+    int controlInterval = 32;
+    int samplesUntilControlTick = 0;
+    bool ramping = false;
+
+    std::array<bool, NumLanes> active {};
+
+    double sampleRate = 44100.0;
+    double rampDurationSeconds = 0.05;
+};
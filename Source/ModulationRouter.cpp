@@ -0,0 +1,180 @@
+/*
+  ==============================================================================
+
+    ModulationRouter.cpp
+    Created: 16 Oct 2026 10:00:00am
+    Author:  Olivier Doaré
+
+  ==============================================================================
+*/
+
+#include "ModulationRouter.h"
+
+namespace
+{
+    struct TargetInfo
+    {
+        const char* name;
+        const char* parameterID;
+        float ParameterSnapshot::* field;
+        float AttractorOffsets::* offset;
+    };
+
+    // Indexed by the target choice. Entry 0 is "Off".
+    const TargetInfo targetInfos[] =
+    {
+        { "Off",    nullptr,  nullptr,                    nullptr },
+        { "Sigma",  "SIGMA",  &ParameterSnapshot::sigma,  &AttractorOffsets::sigma },
+        { "Rho",    "RHO",    &ParameterSnapshot::rho,    &AttractorOffsets::rho },
+        { "Beta",   "BETA",   &ParameterSnapshot::beta,   &AttractorOffsets::beta },
+        { "Mx",     "MX",     &ParameterSnapshot::mx,     &AttractorOffsets::mx },
+        { "My",     "MY",     &ParameterSnapshot::my,     &AttractorOffsets::my },
+        { "Mz",     "MZ",     &ParameterSnapshot::mz,     &AttractorOffsets::mz },
+        { "Cx",     "CX",     &ParameterSnapshot::cx,     &AttractorOffsets::cx },
+        { "Cy",     "CY",     &ParameterSnapshot::cy,     &AttractorOffsets::cy },
+        { "Cz",     "CZ",     &ParameterSnapshot::cz,     &AttractorOffsets::cz },
+        { "Taming", "TAMING", &ParameterSnapshot::taming, &AttractorOffsets::taming }
+    };
+
+    constexpr int numSourceChoices = static_cast<int>(ModulationRouter::Source::numSources);
+}
+
+ModulationRouter::ModulationRouter(juce::AudioProcessorValueTreeState& state)
+    : apvts(state)
+{
+    static_assert (std::size(targetInfos) == numTargets, "One route per target choice");
+
+    for (int i = 0; i < numTargets; ++i)
+    {
+        const auto& info = targetInfos[i];
+        if (info.parameterID == nullptr)
+            continue;
+
+        if (auto* param = dynamic_cast<juce::RangedAudioParameter*>(apvts.getParameter(info.parameterID)))
+        {
+            const auto range = param->getNormalisableRange().getRange();
+            routes[(size_t) i] = { info.field, info.offset, range.getStart(), range.getEnd() };
+        }
+    }
+
+    for (int slot = 0; slot < numModulationSlots; ++slot)
+    {
+        const auto sourceID = getSourceParameterID(slot);
+        const auto targetID = getTargetParameterID(slot);
+
+        parameterChanged(sourceID, apvts.getRawParameterValue(sourceID)->load());
+        parameterChanged(targetID, apvts.getRawParameterValue(targetID)->load());
+
+        apvts.addParameterListener(sourceID, this);
+        apvts.addParameterListener(targetID, this);
+    }
+}
+
+ModulationRouter::~ModulationRouter()
+{
+    for (int slot = 0; slot < numModulationSlots; ++slot)
+    {
+        apvts.removeParameterListener(getSourceParameterID(slot), this);
+        apvts.removeParameterListener(getTargetParameterID(slot), this);
+    }
+}
+
+void ModulationRouter::parameterChanged(const juce::String& parameterID, float newValue)
+{
+    const int index = static_cast<int>(newValue);
+
+    for (int slot = 0; slot < numModulationSlots; ++slot)
+    {
+        if (parameterID == getSourceParameterID(slot))
+            slotSources[(size_t) slot].store(juce::jlimit(0, numSourceChoices - 1, index));
+        else if (parameterID == getTargetParameterID(slot))
+            slotTargets[(size_t) slot].store(juce::jlimit(0, numTargets - 1, index));
+    }
+}
+
+bool ModulationRouter::computeOffsets(const ParameterSnapshot& parameters, const SourceValues& sources, AttractorOffsets& offsets) const
+{
+    offsets = {};
+
+    // Sum the contribution of every slot, per target.
+    std::array<float, numTargets> depth {};
+    bool active = false;
+
+    for (int slot = 0; slot < numModulationSlots; ++slot)
+    {
+        const int source = slotSources[(size_t) slot].load(std::memory_order_relaxed);
+        const int target = slotTargets[(size_t) slot].load(std::memory_order_relaxed);
+        const float amount = parameters.modAmount[slot];
+
+        if (source == 0 || target == 0 || amount == 0.0f)
+            continue;
+
+        depth[(size_t) target] += amount * sources[(size_t) source];
+        active = true;
+    }
+
+    if (! active)
+        return false;
+
+    for (int target = 1; target < numTargets; ++target)
+    {
+        const auto& route = routes[(size_t) target];
+        const float d = juce::jlimit(-1.0f, 1.0f, depth[(size_t) target]);
+
+        if (route.field == nullptr || d == 0.0f)
+            continue;
+
+        const float base = parameters.*(route.field);
+
+        offsets.*(route.offset) = d >= 0.0f ? d * (route.rangeEnd - base)     // Modulate towards max
+                                            : d * (base - route.rangeStart);  // Modulate towards min
+    }
+
+    return true;
+}
+
+juce::String ModulationRouter::getSourceParameterID(int slot)
+{
+    return slot == 0 ? juce::String("MOD_SOURCE") : "MOD" + juce::String(slot + 1) + "_SOURCE";
+}
+
+juce::String ModulationRouter::getTargetParameterID(int slot)
+{
+    return slot == 0 ? juce::String("MOD_TARGET") : "MOD" + juce::String(slot + 1) + "_TARGET";
+}
+
+juce::String ModulationRouter::getAmountParameterID(int slot)
+{
+    return slot == 0 ? juce::String("MOD_AMOUNT") : "MOD" + juce::String(slot + 1) + "_AMOUNT";
+}
+
+juce::StringArray ModulationRouter::getSourceNames()
+{
+    return { "Off", "LFO 1", "LFO 2", "Mod Env", "CC01", "Velocity", "Aftertouch" };
+}
+
+juce::StringArray ModulationRouter::getTargetNames()
+{
+    juce::StringArray names;
+    for (const auto& info : targetInfos)
+        names.add(info.name);
+    return names;
+}
+
+void ModulationRouter::addParameters(juce::AudioProcessorValueTreeState::ParameterLayout& layout)
+{
+    for (int slot = 0; slot < numModulationSlots; ++slot)
+    {
+        const auto slotName = slot == 0 ? juce::String("Mod") : "Mod " + juce::String(slot + 1);
+
+        // The first slot defaults to CC01, as it was the only modulation source before the matrix.
+        const int defaultSource = slot == 0 ? static_cast<int>(Source::CC1) : 0;
+
+        layout.add(std::make_unique<juce::AudioParameterChoice>(getSourceParameterID(slot), slotName + " Source",
+                                                                getSourceNames(), defaultSource));
+        layout.add(std::make_unique<juce::AudioParameterChoice>(getTargetParameterID(slot), slotName + " Target",
+                                                                getTargetNames(), 0));
+        layout.add(std::make_unique<juce::AudioParameterFloat>(getAmountParameterID(slot), slotName + " Amount",
+                                                               juce::NormalisableRange<float>(-1.0f, 1.0f, 0.01f), 0.0f));
+    }
+}
@@ -0,0 +1,90 @@
+/*
+  ==============================================================================
+
+    ModulationRouter.h
+    Created: 16 Oct 2026 10:00:00am
+    Author:  Olivier Doaré
+
+  ==============================================================================
+*/
+
+#pragma once
+
+#include <JuceHeader.h>
+#include "ParameterSnapshot.h"
+
+/**
+ * Modulation matrix: routes the modulation sources (LFOs, modulation envelope,
+ * CC01, velocity, aftertouch) onto the attractor parameters.
+ *
+ * Each slot has a source, a target and an amount. Every possible target is
+ * resolved once, at construction: the snapshot field it reads, the offset field
+ * it drives and the bounds of its range. Sources and targets are listened to
+ * and only swap atomic indices, so the audio thread never looks up a parameter
+ * by name and never allocates.
+ *
+ * The matrix is evaluated once per control tick. The contributions of all the
+ * slots aimed at a target are summed, and the result moves the target towards
+ * the top of its range (positive) or the bottom (negative), as a fraction of
+ * the distance. It never leaves the range.
+ */
+class ModulationRouter : private juce::AudioProcessorValueTreeState::Listener
+{
+public:
+    enum class Source
+    {
+        Off,
+        LFO1,
+        LFO2,
+        ModEnvelope,
+        CC1,
+        Velocity,
+        Aftertouch,
+        numSources
+    };
+
+    // Current value of each source, indexed by Source. LFOs are bipolar, the others unipolar.
+    using SourceValues = std::array<float, static_cast<size_t>(Source::numSources)>;
+
+    explicit ModulationRouter(juce::AudioProcessorValueTreeState& apvts);
+    ~ModulationRouter() override;
+
+    /**
+     * Computes the offsets to add to the attractor parameters for the current
+     * source values. Returns false, with all offsets at zero, when no slot is active.
+     */
+    bool computeOffsets(const ParameterSnapshot& parameters, const SourceValues& sources, AttractorOffsets& offsets) const;
+
+    /** Parameter IDs of a slot. Slot 0 keeps the original MOD_TARGET / MOD_AMOUNT IDs. */
+    static juce::String getSourceParameterID(int slot);
+    static juce::String getTargetParameterID(int slot);
+    static juce::String getAmountParameterID(int slot);
+
+    /** The source and target choices, in order. */
+    static juce::StringArray getSourceNames();
+    static juce::StringArray getTargetNames();
+
+    /** Adds the source, target and amount parameters of every slot. */
+    static void addParameters(juce::AudioProcessorValueTreeState::ParameterLayout& layout);
+
+private:
+    void parameterChanged(const juce::String& parameterID, float newValue) override;
+
+    struct Route
+    {
+        float ParameterSnapshot::* field = nullptr;
+        float AttractorOffsets::* offset = nullptr;
+        float rangeStart = 0.0f;
+        float rangeEnd = 0.0f;
+    };
+
+    static constexpr int numTargets = 11;
+    std::array<Route, numTargets> routes {};
+
+    std::array<std::atomic<int>, numModulationSlots> slotSources {};
+    std::array<std::atomic<int>, numModulationSlots> slotTargets {};
+
+    juce::AudioProcessorValueTreeState& apvts;
+
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR (ModulationRouter)
+};
@@ -0,0 +1,82 @@
+/*
+  ==============================================================================
+
+    ParameterSnapshot.h
+    Created: 16 Oct 2026 10:00:00am
+    Author:  Olivier Doaré
+
+  ==============================================================================
+*/
+
+#pragma once
+
+#include <type_traits>
+
+/** Number of slots in the modulation matrix. */
+static constexpr int numModulationSlots = 4;
+
+/**
+ * Plain copy of every parameter the audio thread needs, filled once at the top
+ * of each block by the processor.
+ *
+ * The DSP stages (oscillator, mixer, envelope, pitch control) only read from
+ * this structure, so each parameter atomic is loaded once per block and no
+ * parameter is looked up by name on the audio thread. It is aligned to a cache
+ * line and kept small so the whole block's parameters stay in one or two lines.
+ */
+struct alignas(64) ParameterSnapshot
+{
+    // --- Attractor ---
+    float sigma = 10.0f, rho = 28.0f, beta = 8.0f / 3.0f;
+    float mx = 1.0f, my = 1.0f, mz = 1.0f;
+    float cx = 0.0f, cy = 0.0f, cz = 0.0f;
+    float taming = 0.0f;
+    float timestep = 0.01f;
+    int integrator = 0;
+    int warmStart = 1; // 0: off, 1: fixed phase, 2: random phase
+
+    // --- Mixer (levels as linear gains, pans in [-1, 1]) ---
+    float levelX = 1.0f, panX = 0.0f;
+    float levelY = 1.0f, panY = 0.0f;
+    float levelZ = 1.0f, panZ = 0.0f;
+    float outputLevel = 1.0f;
+
+    // --- Amplitude envelope ---
+    float attack = 0.1f, decay = 0.1f, sustain = 1.0f, release = 0.1f;
+
+    // --- Modulation (sources and targets are held by the ModulationRouter) ---
+    float modAmount[numModulationSlots] {};
+    float lfo1Rate = 1.0f, lfo2Rate = 1.0f;
+    int lfo1Shape = 0, lfo2Shape = 0;
+    float modEnvAttack = 0.1f, modEnvDecay = 0.1f, modEnvSustain = 1.0f, modEnvRelease = 0.1f;
+
+    // --- Frequency control ---
+    float targetFrequency = 0.0f;
+    float kp = 0.0f, ki = 0.0f, kd = 0.0f;
+    float pidInterval = 0.01f;
+    int pitchSource = 0; // 0-2: X, Y, Z signals, 3-5: Poincaré sections
+    int pitchHop = 1024;
+    int pitchDetector = 0; // PitchDetector::Type
+    bool gainScheduling = true;
+
+    // --- Voices ---
+    int polyphony = 0; // 0: monophonic, 1: 8 voices, 2: 16 voices
+    int unisonCopies = 1; // Lead included, 1: off
+    float unisonDetune = 0.3f;
+    float unisonWidth = 0.7f;
+};
+
+static_assert (std::is_trivially_copyable<ParameterSnapshot>::value,
+               "ParameterSnapshot is copied wholesale on the audio thread");
+
+/**
+ * Amounts added to the smoothed attractor parameters by the modulation matrix,
+ * refreshed once per control tick.
+ */
+struct AttractorOffsets
+{
+    float sigma = 0.0f, rho = 0.0f, beta = 0.0f;
+    float mx = 0.0f, my = 0.0f, mz = 0.0f;
+    float cx = 0.0f, cy = 0.0f, cz = 0.0f;
+    float taming = 0.0f;
+};
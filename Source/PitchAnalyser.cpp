@@ -0,0 +1,278 @@
+/*
+  ==============================================================================
+
+    PitchAnalyser.cpp
+    Created: 16 Oct 2026 10:00:00am
+    Author:  Olivier Doaré
+
+  ==============================================================================
+*/
+
+#include "PitchAnalyser.h"
+
+PitchAnalyser::PitchAnalyser()
+    : juce::Thread("Pitch Analysis")
+{
+    for (auto& detectorsForFactor : detectors)
+        for (int i = 0; i < numDetectorTypes; ++i)
+            detectorsForFactor[(size_t) i] = PitchDetector::create(static_cast<PitchDetector::Type>(i));
+}
+
+PitchAnalyser::~PitchAnalyser()
+{
+    release();
+}
+
+void PitchAnalyser::prepare(double newSampleRate, int newWindowSize, bool analyseSynchronously)
+{
+    release();
+
+    synchronous = analyseSynchronously;
+    sampleRate = newSampleRate;
+    windowSize = newWindowSize;
+
+    // Decimated, the window keeps up to windowSize samples, as long as it fits
+    // in maxWindowSeconds of host time, and never covers less than windowSize
+    // host samples.
+    const int maxHostWindow = juce::jmax(windowSize, static_cast<int>(maxWindowSeconds * sampleRate));
+
+    for (int i = 0; i < numFactors; ++i)
+    {
+        int size = windowSize;
+        while (size > (windowSize >> i) && (size << i) > maxHostWindow)
+            size /= 2;
+
+        decimatedWindowSizes[(size_t) i] = size;
+
+        for (auto& detector : detectors[(size_t) i])
+            detector->prepare(sampleRate / (1 << i), size);
+    }
+
+    // The FIFO holds a few windows, so the worker can be late by a few hops
+    // before any sample is dropped.
+    fifo.setTotalSize(4 * windowSize);
+    fifo.reset();
+    fifoBuffer.assign((size_t) (4 * windowSize), 0.0f);
+    drainBuffer.assign((size_t) windowSize, 0.0f);
+    ring.assign((size_t) (2 * windowSize), 0.0f);
+
+    samplesDropped = 0;
+    resetPending = false;
+    samplesConsumed = 0;
+    samplesPushed = 0;
+    estimateSequence = 0;
+    publishedFrequency = 0.0f;
+    publishedConfidence = 0.0f;
+    publishedTime = 0;
+    ignoreEstimatesBefore = 0;
+    applyDecimationFactor(requestedFactor.load());
+    setHopSize(hopSize.load());
+    clearWindow();
+    reset();
+
+    if (! synchronous)
+        startThread();
+}
+
+void PitchAnalyser::release()
+{
+    stopThread(1000);
+}
+
+void PitchAnalyser::setHopSize(int numSamples)
+{
+    hopSize = juce::jlimit(1, juce::jmax(1, windowSize), numSamples);
+}
+
+void PitchAnalyser::setTargetFrequency(float hz)
+{
+    if (hz <= 0.0f)
+        return;
+
+    int factor = Decimator::maxFactor;
+    while (factor > 1 && sampleRate / factor < minSamplesPerPeriod * hz)
+        factor /= 2;
+
+    requestedFactor.store(factor, std::memory_order_relaxed);
+}
+
+void PitchAnalyser::reset()
+{
+    // The window itself belongs to whichever side runs the analysis: ask the
+    // worker to clear it, or clear it here when analysing synchronously.
+    if (synchronous)
+        clearWindow();
+    else
+        resetPending = true;
+
+    // Estimates from windows centred before this point are stale.
+    ignoreEstimatesBefore = samplesPushed;
+    latestEstimateTime = samplesPushed;
+    latestFrequency = 0.0f;
+    latestConfidence = 0.0f;
+}
+
+void PitchAnalyser::pushSamples(const float* samples, int numSamples)
+{
+    if (synchronous)
+    {
+        consume(samples, numSamples);
+    }
+    else
+    {
+        int start1, size1, start2, size2;
+        fifo.prepareToWrite(numSamples, start1, size1, start2, size2);
+
+        if (size1 > 0) std::copy(samples, samples + size1, fifoBuffer.data() + start1);
+        if (size2 > 0) std::copy(samples + size1, samples + size1 + size2, fifoBuffer.data() + start2);
+        fifo.finishedWrite(size1 + size2);
+
+        // If the worker has fallen behind, the samples that do not fit are
+        // dropped, but still counted so the estimate timestamps stay aligned.
+        if (const int dropped = numSamples - size1 - size2; dropped > 0)
+            samplesDropped.fetch_add((uint32_t) dropped);
+    }
+
+    samplesPushed += (uint32_t) numSamples;
+
+    // Pick up any estimate published since the last call.
+    pollEstimate();
+}
+
+void PitchAnalyser::pollEstimate()
+{
+    const uint32_t sequence = estimateSequence.load(std::memory_order_acquire);
+    if ((sequence & 1) != 0)
+        return; // Being written
+
+    const uint32_t time = publishedTime.load(std::memory_order_relaxed);
+    const float frequency = publishedFrequency.load(std::memory_order_relaxed);
+    const float confidence = publishedConfidence.load(std::memory_order_relaxed);
+
+    // The reads must not move past the check that nothing was written meanwhile
+    std::atomic_thread_fence(std::memory_order_acquire);
+    if (estimateSequence.load(std::memory_order_relaxed) != sequence)
+        return;
+
+    // Nothing new, or an estimate of a window centred before the last reset.
+    if (time == latestEstimateTime || static_cast<int32_t>(time - ignoreEstimatesBefore) <= 0)
+        return;
+
+    latestFrequency = frequency;
+    latestConfidence = confidence;
+    latestEstimateTime = time;
+}
+
+void PitchAnalyser::publish(float estimate, float confidence, uint32_t time)
+{
+    // Only one thread publishes: the worker, or the audio thread when synchronous
+    const uint32_t sequence = estimateSequence.load(std::memory_order_relaxed);
+
+    // Odd while writing. The fields must not be written before the reader can see that.
+    estimateSequence.store(sequence + 1, std::memory_order_relaxed);
+    std::atomic_thread_fence(std::memory_order_release);
+
+    publishedFrequency.store(estimate, std::memory_order_relaxed);
+    publishedConfidence.store(juce::jlimit(0.0f, 1.0f, confidence), std::memory_order_relaxed);
+    publishedTime.store(time, std::memory_order_relaxed);
+
+    estimateSequence.store(sequence + 2, std::memory_order_release);
+}
+
+void PitchAnalyser::run()
+{
+    while (! threadShouldExit())
+    {
+        if (resetPending.exchange(false))
+            clearWindow();
+
+        samplesConsumed += samplesDropped.exchange(0);
+
+        int start1, size1, start2, size2;
+        fifo.prepareToRead(juce::jmin(fifo.getNumReady(), windowSize), start1, size1, start2, size2);
+
+        if (size1 + size2 > 0)
+        {
+            std::copy(fifoBuffer.data() + start1, fifoBuffer.data() + start1 + size1, drainBuffer.data());
+            std::copy(fifoBuffer.data() + start2, fifoBuffer.data() + start2 + size2, drainBuffer.data() + size1);
+            fifo.finishedRead(size1 + size2);
+
+            consume(drainBuffer.data(), size1 + size2);
+            continue;
+        }
+
+        // Nothing to do: sleep for about half a hop.
+        const int hop = hopSize.load(std::memory_order_relaxed);
+        wait(juce::jmax(1, static_cast<int>(500.0 * hop / sampleRate)));
+    }
+}
+
+void PitchAnalyser::consume(const float* samples, int numSamples)
+{
+    if (const int factor = requestedFactor.load(std::memory_order_relaxed); factor != decimator.getFactor())
+        applyDecimationFactor(factor);
+
+    for (int i = 0; i < numSamples; ++i)
+    {
+        ++samplesConsumed;
+
+        float sample;
+        if (decimator.processSample(samples[i], sample))
+        {
+            ring[(size_t) writePosition] = sample;
+            ring[(size_t) (writePosition + decimatedWindowSize)] = sample;
+
+            if (++writePosition == decimatedWindowSize)
+                writePosition = 0;
+
+            // The hop is counted at the decimated rate too
+            if (--samplesUntilAnalysis <= 0)
+                analyse();
+        }
+    }
+}
+
+void PitchAnalyser::analyse()
+{
+    samplesUntilAnalysis = getDecimatedHopSize();
+
+    // The oldest sample of the window sits at the write position, so the
+    // mirrored half makes the whole window readable in one piece.
+    const int type = juce::jlimit(0, numDetectorTypes - 1, requestedDetector.load(std::memory_order_relaxed));
+    auto& detector = *detectors[(size_t) getFactorIndex(decimator.getFactor())][(size_t) type];
+    const float estimate = detector.detect(ring.data() + writePosition);
+
+    // The window ends where the decimator's output is, one group delay behind the input.
+    const int hostWindowSize = decimatedWindowSize * decimator.getFactor();
+    const auto windowCentre = samplesConsumed - static_cast<uint32_t>(decimator.getLatencySamples() + hostWindowSize / 2);
+
+    publish(estimate, detector.getConfidence(), windowCentre);
+}
+
+void PitchAnalyser::clearWindow()
+{
+    std::fill(ring.begin(), ring.end(), 0.0f);
+    writePosition = 0;
+    samplesUntilAnalysis = getDecimatedHopSize();
+}
+
+void PitchAnalyser::applyDecimationFactor(int factor)
+{
+    // The window holds samples at the old rate, so it starts over.
+    decimator.setFactor(factor);
+    decimatedWindowSize = decimatedWindowSizes[(size_t) getFactorIndex(factor)];
+    clearWindow();
+}
+
+int PitchAnalyser::getDecimatedHopSize() const
+{
+    return juce::jmax(1, hopSize.load(std::memory_order_relaxed) / decimator.getFactor());
+}
+
+int PitchAnalyser::getFactorIndex(int factor)
+{
+    int index = 0;
+    while ((1 << index) < factor)
+        ++index;
+    return index;
+}
@@ -0,0 +1,155 @@
+/*
+  ==============================================================================
+
+    PitchAnalyser.h
+    Created: 16 Oct 2026 10:00:00am
+    Author:  Olivier Doaré
+
+  ==============================================================================
+*/
+
+#pragma once
+
+#include <JuceHeader.h>
+#include "Decimator.h"
+#include "PitchDetector.h"
+
+/**
+ * Measures the frequency of the pitch-source signal, one hop at a time, on a
+ * worker thread.
+ *
+ * The audio thread only copies the pitch-source samples into a lock-free
+ * single-producer/single-consumer FIFO and reads back the latest estimate.
+ * The worker drains the FIFO into a ring buffer that is written twice (at i
+ * and i + windowSize), so the latest window is always contiguous, and runs the
+ * selected PitchDetector once every hopSize samples.
+ *
+ * Low notes do not need the full sample rate: the signal can be decimated by
+ * 2, 4 or 8 before the window, picked from the target frequency. Decimated,
+ * the window covers more host time, so it holds more periods of a low note,
+ * up to maxWindowSeconds, which bounds the latency; it is still fewer samples
+ * to analyse than the undecimated window. The hop keeps its length in host
+ * samples, so the analyses run at the same rate. There is one set of
+ * detectors per factor, each prepared for its window, so a change of factor
+ * never allocates.
+ *
+ * Each estimate is published together with the detector's confidence and the
+ * position of its window in the input stream, so the audio thread knows how
+ * much to trust it and how old it is. Smoothing and extrapolating the
+ * estimates is left to the FrequencyTracker. When rendering
+ * offline the analysis runs synchronously instead, so the result does not
+ * depend on how fast the worker keeps up. The choice is made once in
+ * prepare(): the window then belongs to a single thread until the next one.
+ */
+class PitchAnalyser : private juce::Thread
+{
+public:
+    PitchAnalyser();
+    ~PitchAnalyser() override;
+
+    /**
+     * Allocates the buffers and, unless analyseSynchronously is true, starts
+     * the worker. Synchronously, the analysis runs in pushSamples() on the
+     * calling (audio) thread, e.g. for offline rendering. Not real-time safe.
+     */
+    void prepare(double sampleRate, int windowSize, bool analyseSynchronously);
+
+    /** Stops the worker. */
+    void release();
+
+    /** Number of host samples between two analyses. Clamped to the window size. */
+    void setHopSize(int numSamples);
+
+    /**
+     * Picks the decimation factor for the expected pitch: the largest of 1, 2, 4
+     * or 8 that keeps the decimated rate above minSamplesPerPeriod times the
+     * target, so a few harmonics and a detuned pitch still pass. Ignored for 0.
+     */
+    void setTargetFrequency(float hz);
+
+    /** Selects the detector used from the next analysis on. */
+    void setDetector(PitchDetector::Type type) { requestedDetector.store((int) type, std::memory_order_relaxed); }
+
+    /** Clears the analysis window and the measured frequency. Safe to call from the audio thread. */
+    void reset();
+
+    /** Adds a block of the pitch-source signal. Called from the audio thread. */
+    void pushSamples(const float* samples, int numSamples);
+
+    /** The latest estimate in Hz, or 0 if no pitch was found. */
+    float getLatestEstimate() const { return latestFrequency; }
+
+    /** The detector's confidence in the latest estimate, from 0 to 1. */
+    float getLatestConfidence() const { return latestConfidence; }
+
+    /** Stream position (in samples pushed) of the centre of the window behind the latest estimate. */
+    uint32_t getLatestEstimateTime() const { return latestEstimateTime; }
+
+    /** Age in samples of the centre of the window behind the latest estimate. */
+    int getLatencySamples() const { return static_cast<int>(samplesPushed - latestEstimateTime); }
+
+private:
+    void run() override;
+
+    // Worker side (or audio side when synchronous): fills the window and analyses it every hop.
+    void consume(const float* samples, int numSamples);
+    void analyse();
+    void clearWindow();
+    void applyDecimationFactor(int factor);
+    int getDecimatedHopSize() const;
+    static int getFactorIndex(int factor);
+
+    // Publishes an estimate, its confidence and the stream position of the
+    // centre of its window, as one consistent set.
+    void publish(float estimate, float confidence, uint32_t time);
+    void pollEstimate();
+
+    static constexpr float minSamplesPerPeriod = 32.0f;
+    static constexpr double maxWindowSeconds = 0.2; // Half of it is the analysis latency
+
+    static constexpr int numDetectorTypes = 3;
+    static constexpr int numFactors = 4; // 1, 2, 4 and 8
+
+    // One detector of each type for each factor, all prepared, so switching never allocates
+    std::array<std::array<std::unique_ptr<PitchDetector>, numDetectorTypes>, numFactors> detectors;
+    std::array<int, numFactors> decimatedWindowSizes {};
+    double sampleRate = 44100.0;
+    int windowSize = 0; // In host samples, undecimated
+    bool synchronous = false; // Set by prepare() while the worker is stopped
+
+    // --- Audio thread -> worker ---
+    juce::AbstractFifo fifo { 1 };
+    std::vector<float> fifoBuffer;
+    std::atomic<uint32_t> samplesDropped { 0 };
+    std::atomic<bool> resetPending { false };
+    std::atomic<int> hopSize { 1024 };
+    std::atomic<int> requestedFactor { 1 };
+    std::atomic<int> requestedDetector { 0 };
+
+    // --- Worker state ---
+    Decimator decimator;
+    std::vector<float> ring;
+    std::vector<float> drainBuffer;
+    int decimatedWindowSize = 0;
+    int writePosition = 0;
+    int samplesUntilAnalysis = 0;
+    uint32_t samplesConsumed = 0;
+
+    // --- Worker -> audio thread ---
+    // A seqlock: the sequence is odd while publish() writes the fields, and the
+    // reader keeps what it read only if the sequence was even and unchanged
+    // around its reads. A torn estimate is skipped and picked up next block.
+    std::atomic<uint32_t> estimateSequence { 0 };
+    std::atomic<float> publishedFrequency { 0.0f };
+    std::atomic<float> publishedConfidence { 0.0f };
+    std::atomic<uint32_t> publishedTime { 0 };
+
+    // --- Audio thread state ---
+    uint32_t samplesPushed = 0;
+    uint32_t latestEstimateTime = 0;
+    uint32_t ignoreEstimatesBefore = 0;
+    float latestFrequency = 0.0f;
+    float latestConfidence = 0.0f;
+
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR (PitchAnalyser)
+};
@@ -0,0 +1,227 @@
+/*
+  ==============================================================================
+
+    PitchDetector.cpp
+    Created: 16 Oct 2026 10:00:00am
+    Author:  Olivier Doaré
+
+  ==============================================================================
+*/
+
+#include "PitchDetector.h"
+
+std::unique_ptr<PitchDetector> PitchDetector::create(Type type)
+{
+    switch (type)
+    {
+        case Type::YIN:          return std::make_unique<YINDetector>();
+        case Type::ZeroCrossing: return std::make_unique<ZeroCrossingDetector>();
+        case Type::MPM:
+        default:                 return std::make_unique<MPMDetector>();
+    }
+}
+
+float PitchDetector::measurePeriodicity(const float* window, int windowSize, double period)
+{
+    const int lag = juce::roundToInt(period);
+    if (lag <= 0 || lag >= windowSize)
+        return 0.0f;
+
+    double correlation = 0.0, energyA = 0.0, energyB = 0.0;
+    for (int i = 0; i < windowSize - lag; ++i)
+    {
+        correlation += (double) window[i] * window[i + lag];
+        energyA += (double) window[i] * window[i];
+        energyB += (double) window[i + lag] * window[i + lag];
+    }
+
+    if (energyA <= 1e-12 || energyB <= 1e-12)
+        return 0.0f;
+
+    return juce::jlimit(0.0f, 1.0f, static_cast<float>(correlation / std::sqrt(energyA * energyB)));
+}
+
+//==============================================================================
+MPMDetector::MPMDetector()
+    : mpm(44100.0, 4096)
+{
+}
+
+void MPMDetector::prepare(double newSampleRate, int newWindowSize)
+{
+    sampleRate = newSampleRate;
+    windowSize = newWindowSize;
+    mpm.setBufferSize(windowSize);
+    mpm.setSampleRate(sampleRate);
+}
+
+float MPMDetector::detect(const float* window)
+{
+    const float pitch = mpm.getPitch(window);
+
+    // MPM returns -1 if no frequency is detected
+    confidence = pitch > 0.0f ? measurePeriodicity(window, windowSize, sampleRate / pitch) : 0.0f;
+    return pitch > 0.0f ? pitch : 0.0f;
+}
+
+//==============================================================================
+const juce::dsp::FFT& YINDetector::SharedPlans::get(int order)
+{
+    const juce::ScopedLock sl (lock);
+
+    auto& plan = plans[(size_t) order];
+    if (plan == nullptr)
+        plan = std::make_unique<juce::dsp::FFT>(order);
+
+    return *plan;
+}
+
+void YINDetector::prepare(double newSampleRate, int newWindowSize)
+{
+    sampleRate = newSampleRate;
+    windowSize = newWindowSize;
+
+    // Zero-padded to the next power of two at least twice the window
+    const int order = juce::jmax(1, juce::roundToInt(std::ceil(std::log2(2.0 * windowSize))));
+    fft = &sharedPlans->get(order);
+
+    fftData.assign((size_t) (2 * fft->getSize()), 0.0f);
+    energy.assign((size_t) windowSize + 1, 0.0);
+    difference.assign((size_t) windowSize / 2, 1.0f);
+}
+
+float YINDetector::detect(const float* window)
+{
+    const int maxLag = windowSize / 2;
+    confidence = 0.0f;
+
+    // Step 1: linear autocorrelation r(tau) through the power spectrum
+    std::copy(window, window + windowSize, fftData.begin());
+    std::fill(fftData.begin() + windowSize, fftData.end(), 0.0f);
+    fft->performRealOnlyForwardTransform(fftData.data(), true);
+
+    for (int i = 0; i <= fft->getSize(); i += 2)
+    {
+        const float real = fftData[(size_t) i];
+        const float imag = fftData[(size_t) i + 1];
+        fftData[(size_t) i] = real * real + imag * imag;
+        fftData[(size_t) i + 1] = 0.0f;
+    }
+
+    fft->performRealOnlyInverseTransform(fftData.data());
+
+    // Running energy of the window, used both for the difference function and
+    // to undo whatever scaling the inverse transform applies.
+    for (int i = 0; i < windowSize; ++i)
+        energy[(size_t) i + 1] = energy[(size_t) i] + (double) window[i] * window[i];
+
+    if (energy[(size_t) windowSize] <= 1e-12 || fftData[0] <= 0.0f)
+        return 0.0f;
+
+    const double scale = energy[(size_t) windowSize] / fftData[0];
+
+    // Step 2: cumulative mean normalised difference. Over the overlapping part,
+    // d(tau) = sum (x[j] - x[j + tau])^2 = E[0, W - tau) + E[tau, W) - 2 r(tau)
+    difference[0] = 1.0f;
+    double runningSum = 0.0;
+
+    for (int tau = 1; tau < maxLag; ++tau)
+    {
+        const double d = energy[(size_t) (windowSize - tau)]
+                       + (energy[(size_t) windowSize] - energy[(size_t) tau])
+                       - 2.0 * scale * fftData[(size_t) tau];
+
+        runningSum += d;
+        difference[(size_t) tau] = runningSum > 1e-12 ? static_cast<float>(d * tau / runningSum) : 1.0f;
+    }
+
+    // Step 3: first dip below the threshold, down to its minimum
+    const int minLag = juce::jmax(2, static_cast<int>(sampleRate / maxFrequency));
+    int period = -1;
+
+    for (int tau = minLag; tau < maxLag; ++tau)
+    {
+        if (difference[(size_t) tau] < threshold)
+        {
+            while (tau + 1 < maxLag && difference[(size_t) tau + 1] <= difference[(size_t) tau])
+                ++tau;
+
+            period = tau;
+            break;
+        }
+    }
+
+    if (period < 0)
+        return 0.0f;
+
+    // Step 4: parabolic interpolation of the minimum
+    float refinedPeriod = (float) period;
+
+    if (period + 1 < maxLag)
+    {
+        const float y1 = difference[(size_t) period - 1];
+        const float y2 = difference[(size_t) period];
+        const float y3 = difference[(size_t) period + 1];
+        const float a = (y1 + y3 - 2.0f * y2) / 2.0f;
+        const float b = (y3 - y1) / 2.0f;
+
+        if (std::abs(a) > 1e-6f)
+            refinedPeriod -= b / (2.0f * a);
+    }
+
+    // The normalised difference is near 0 for a periodic window, near 1 for noise
+    confidence = juce::jlimit(0.0f, 1.0f, 1.0f - difference[(size_t) period]);
+
+    return static_cast<float>(sampleRate / refinedPeriod);
+}
+
+//==============================================================================
+float ZeroCrossingDetector::detect(const float* window)
+{
+    confidence = 0.0f;
+
+    double sum = 0.0, sumOfSquares = 0.0;
+    for (int i = 0; i < windowSize; ++i)
+    {
+        sum += window[i];
+        sumOfSquares += (double) window[i] * window[i];
+    }
+
+    const double mean = sum / windowSize;
+    const double variance = sumOfSquares / windowSize - mean * mean;
+    if (variance <= 1e-12)
+        return 0.0f;
+
+    const float centre = static_cast<float>(mean);
+    const float threshold = static_cast<float>(hysteresis * std::sqrt(variance));
+
+    // Interpolated positions of the first and the last upward crossing
+    bool armed = false;
+    int numCrossings = 0;
+    float firstCrossing = 0.0f, lastCrossing = 0.0f;
+
+    for (int i = 1; i < windowSize; ++i)
+    {
+        const float previous = window[i - 1] - centre;
+        const float current = window[i] - centre;
+
+        if (current < -threshold)
+            armed = true;
+
+        if (armed && previous < 0.0f && current >= 0.0f)
+        {
+            lastCrossing = (float) (i - 1) + previous / (previous - current);
+            if (numCrossings++ == 0)
+                firstCrossing = lastCrossing;
+            armed = false;
+        }
+    }
+
+    if (numCrossings < 2)
+        return 0.0f;
+
+    const double period = (lastCrossing - firstCrossing) / (numCrossings - 1);
+    confidence = measurePeriodicity(window, windowSize, period);
+
+    return static_cast<float>(sampleRate / period);
+}
@@ -0,0 +1,133 @@
+/*
+  ==============================================================================
+
+    PitchDetector.h
+    Created: 16 Oct 2026 10:00:00am
+    Author:  Olivier Doaré
+
+  ==============================================================================
+*/
+
+#pragma once
+
+#include <JuceHeader.h>
+
+/**
+ * Estimates the fundamental frequency of one analysis window.
+ *
+ * The PitchAnalyser owns one detector of each kind and calls the one selected
+ * by the PITCH_DETECTOR parameter on its worker thread, so detect() never runs
+ * on the audio thread except when rendering offline.
+ */
+class PitchDetector
+{
+public:
+    enum class Type
+    {
+        MPM,
+        YIN,
+        ZeroCrossing
+    };
+
+    virtual ~PitchDetector() = default;
+
+    /** Allocates the working buffers for windows of windowSize samples. Not real-time safe. */
+    virtual void prepare(double sampleRate, int windowSize) = 0;
+
+    /** Returns the frequency in Hz of the windowSize samples at window, or 0 if none is found. */
+    virtual float detect(const float* window) = 0;
+
+    /** How periodic the last detected window was, from 0 (no pitch) to 1 (exactly periodic). */
+    float getConfidence() const { return confidence; }
+
+    static std::unique_ptr<PitchDetector> create(Type type);
+
+protected:
+    /** Normalised correlation of the window with itself delayed by period samples, clamped to [0, 1]. */
+    static float measurePeriodicity(const float* window, int windowSize, double period);
+
+    // Set by detect(), 0 whenever it returns 0
+    float confidence = 0.0f;
+};
+
+//==============================================================================
+/** McLeod Pitch Method, from the pitch_detector module. */
+class MPMDetector : public PitchDetector
+{
+public:
+    MPMDetector();
+
+    void prepare(double sampleRate, int windowSize) override;
+    float detect(const float* window) override;
+
+private:
+    adamski::PitchMPM mpm;
+
+    // MPM does not expose its clarity, so it is measured again at the detected period
+    double sampleRate = 44100.0;
+    int windowSize = 4096;
+};
+
+//==============================================================================
+/**
+ * YIN, with the difference function computed from an FFT autocorrelation.
+ *
+ * The window is zero-padded to twice its length, so the autocorrelation is
+ * linear rather than circular and the difference function is exact over the
+ * overlapping part of the window. The FFT plans are shared by all instances
+ * of the plugin; only the scratch buffers are per detector, since several
+ * analyses can run at the same time.
+ */
+class YINDetector : public PitchDetector
+{
+public:
+    void prepare(double sampleRate, int windowSize) override;
+    float detect(const float* window) override;
+
+private:
+    /** FFT plans by order, created on first use and shared by every detector in the process. */
+    struct SharedPlans
+    {
+        const juce::dsp::FFT& get(int order);
+
+        juce::CriticalSection lock;
+        std::array<std::unique_ptr<juce::dsp::FFT>, 16> plans;
+    };
+
+    static constexpr float threshold = 0.15f;   // Cumulative mean normalised difference threshold
+    static constexpr float maxFrequency = 4000.0f;
+
+    juce::SharedResourcePointer<SharedPlans> sharedPlans;
+    const juce::dsp::FFT* fft = nullptr;
+
+    double sampleRate = 44100.0;
+    int windowSize = 0;
+    std::vector<float> fftData;        // 2 * fftSize, as the real-only transform requires
+    std::vector<double> energy;        // Running sum of squares, energy[i] = sum of x[0..i)
+    std::vector<float> difference;     // Cumulative mean normalised difference
+};
+
+//==============================================================================
+/**
+ * Counts the upward crossings of the window's mean, with hysteresis, and
+ * measures the period between the first and the last one. Very cheap, but only
+ * reliable on signals with one crossing per period.
+ */
+class ZeroCrossingDetector : public PitchDetector
+{
+public:
+    void prepare(double newSampleRate, int newWindowSize) override
+    {
+        sampleRate = newSampleRate;
+        windowSize = newWindowSize;
+    }
+
+    float detect(const float* window) override;
+
+private:
+    // Hysteresis as a fraction of the window's RMS level
+    static constexpr float hysteresis = 0.1f;
+
+    double sampleRate = 44100.0;
+    int windowSize = 0;
+};
@@ -103,6 +103,11 @@ LorenzAudioProcessorEditor::LorenzAudioProcessorEditor (LorenzAudioProcessor& p,
     measuredFrequencyLabel.setJustificationType(juce::Justification::centred);
     measuredFrequencyLabel.setText("--- Hz", juce::dontSendNotification);
 
+    // The timestep the pitch controller runs at. The TIMESTEP knob keeps the user's setting.
+    addAndMakeVisible(controlledTimestepLabel);
+    controlledTimestepLabel.setColour(juce::Label::textColourId, juce::Colours::orange);
+    controlledTimestepLabel.setJustificationType(juce::Justification::centred);
+
     addAndMakeVisible(pitchSourceSelector);
     // We must manually populate the ComboBox with the choices from the parameter.
     if (auto* choiceParam = dynamic_cast<juce::AudioParameterChoice*>(apvts.getParameter("PITCH_SOURCE")))
@@ -117,9 +122,16 @@ LorenzAudioProcessorEditor::LorenzAudioProcessorEditor (LorenzAudioProcessor& p,
 
     pitchSourceSelector.setColour(juce::ComboBox::backgroundColourId, juce::Colours::transparentBlack);
     pitchSourceSelector.setColour(juce::ComboBox::outlineColourId, juce::Colours::transparentBlack);
+
+    addAndMakeVisible(integratorSelector);
+    if (auto* choiceParam = dynamic_cast<juce::AudioParameterChoice*>(apvts.getParameter("INTEGRATOR")))
+        integratorSelector.addItemList(choiceParam->choices, 1);
+    integratorAttachment = std::make_unique<juce::AudioProcessorValueTreeState::ComboBoxAttachment>(apvts, "INTEGRATOR", integratorSelector);
+    integratorSelector.setColour(juce::ComboBox::backgroundColourId, juce::Colours::transparentBlack);
+    integratorSelector.setColour(juce::ComboBox::outlineColourId, juce::Colours::transparentBlack);
    
 
-    startTimerHz(30); // Update the frequency display 30 times per second
+    startTimerHz(30); // Update the frequency and timestep displays 30 times per second
 
     setSize (720, 480);
 }
@@ -134,6 +146,10 @@ void LorenzAudioProcessorEditor::timerCallback()
     float freq = measuredFrequency.load();
     juce::String freqText = (freq > 0.0f) ? juce::String(freq, 1) + " Hz" : "--- Hz";
     measuredFrequencyLabel.setText(freqText, juce::dontSendNotification);
+
+    const float controlledTimestep = audioProcessor.getControlledTimestep();
+    controlledTimestepLabel.setText(controlledTimestep > 0.0f ? "dt " + juce::String(controlledTimestep, 5) : juce::String(),
+                                    juce::dontSendNotification);
 }
 
 //==============================================================================
@@ -207,12 +223,14 @@ void LorenzAudioProcessorEditor::resized()
     fbButtons.flexDirection = juce::FlexBox::Direction::row;
     fbButtons.items.add(fi(savePresetButton).withFlex(1.f).withMargin(juce::FlexItem::Margin(5, 10, 5, 10)));
     fbButtons.items.add(fi(resetButton).withFlex(1.f).withMargin(juce::FlexItem::Margin(5, 10, 5, 10)));
+    fbButtons.items.add(fi(integratorSelector).withFlex(1.5f).withMargin(juce::FlexItem::Margin(5, 0, 5, 0)));
     fbLorenz.items.add(fi(fbButtons).withFlex(.45f));
     fbF1.items.add(fi(targetFrequencyKnob).withFlex(1.f));
     fbF1.items.add(fi(timestepKnob).withFlex(1.f));
     fbF11.items.add(fi(pitchSourceLabel).withFlex(1.f));
     fbF11.items.add(fi(pitchSourceSelector).withFlex(1.f).withMargin(10).withMargin(juce::FlexItem::Margin(0,5,10,5)));
     fbF11.items.add(fi(measuredFrequencyLabel).withFlex(1.f));
+    fbF11.items.add(fi(controlledTimestepLabel).withFlex(1.f));
     fbF1.items.add(fi(fbF11).withFlex(1.f));
     fbF1.items.add(fi(kpKnob).withFlex(1.f));
     fbF1.items.add(fi(kiKnob).withFlex(1.f));
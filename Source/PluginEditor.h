@@ -95,11 +95,15 @@ private:
 
     juce::Label viewZoomXLabel, viewZoomZLabel, viewZoomYLabel;
     juce::Label measuredFrequencyLabel;
+    juce::Label controlledTimestepLabel;
 
     juce::ComboBox pitchSourceSelector;
     std::unique_ptr<juce::AudioProcessorValueTreeState::ComboBoxAttachment> pitchSourceAttachment;
     juce::Label pitchSourceLabel;
 
+    juce::ComboBox integratorSelector;
+    std::unique_ptr<juce::AudioProcessorValueTreeState::ComboBoxAttachment> integratorAttachment;
+
     juce::TextButton resetButton { "Reset" };
     juce::TextButton savePresetButton { "Save" };
 
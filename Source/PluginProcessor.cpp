@@ -9,6 +9,28 @@
 #include "PluginProcessor.h"
 #include "PluginEditor.h"
 
+namespace
+{
+    // The state variables can have a large range, so we scale them down.
+    constexpr float xScale = 0.025f;
+    constexpr float yScale = 0.025f;
+    constexpr float zScale = 0.0125f;
+
+    // Number of samples between two updates of the smoothed parameters,
+    // both in the oscillator and in the mixer.
+    constexpr int controlInterval = 32;
+
+    // Distance, in attractor units, the state must move back below a Poincaré
+    // section before its next crossing counts. Rejects jitter around the plane.
+    constexpr float poincareHysteresis = 0.5f;
+
+    // X, Y, Z and the pitch source, then the unison X, Y and Z sums for each channel
+    constexpr int oscBufferChannels = 10;
+
+    // Level below which the output filter's tail counts as silence (-100 dB)
+    constexpr float idleThreshold = 1.0e-5f;
+}
+
 //==============================================================================
 LorenzAudioProcessor::LorenzAudioProcessor()
 #ifndef JucePlugin_PreferredChannelConfigurations
@@ -40,8 +62,14 @@ LorenzAudioProcessor::LorenzAudioProcessor()
       decayParam(apvts.getRawParameterValue("DECAY")),
       sustainParam(apvts.getRawParameterValue("SUSTAIN")),
       releaseParam(apvts.getRawParameterValue("RELEASE")),
-      modTargetParam(apvts.getRawParameterValue("MOD_TARGET")),
-      modAmountParam(apvts.getRawParameterValue("MOD_AMOUNT")),
+      lfo1RateParam(apvts.getRawParameterValue("LFO1_RATE")),
+      lfo1ShapeParam(apvts.getRawParameterValue("LFO1_SHAPE")),
+      lfo2RateParam(apvts.getRawParameterValue("LFO2_RATE")),
+      lfo2ShapeParam(apvts.getRawParameterValue("LFO2_SHAPE")),
+      modEnvAttackParam(apvts.getRawParameterValue("MODENV_ATTACK")),
+      modEnvDecayParam(apvts.getRawParameterValue("MODENV_DECAY")),
+      modEnvSustainParam(apvts.getRawParameterValue("MODENV_SUSTAIN")),
+      modEnvReleaseParam(apvts.getRawParameterValue("MODENV_RELEASE")),
       targetFrequencyRangedParam(static_cast<juce::RangedAudioParameter*>(apvts.getParameter("TARGET_FREQ"))),
       targetFrequencyParam(apvts.getRawParameterValue("TARGET_FREQ")),
       kpParam(apvts.getRawParameterValue("KP")),
@@ -49,18 +77,31 @@ LorenzAudioProcessor::LorenzAudioProcessor()
       kdParam(apvts.getRawParameterValue("KD")),
       pitchSourceParam(apvts.getRawParameterValue("PITCH_SOURCE")),
       pidIntervalParam(apvts.getRawParameterValue("PID_INTERVAL")),
-      pitchDetector(44100.0, PITCHBUFFERSIZE), mxParam(apvts.getRawParameterValue("MX")), //
+      pitchHopParam(apvts.getRawParameterValue("PITCH_HOP")),
+      pitchDetectorParam(apvts.getRawParameterValue("PITCH_DETECTOR")),
+      gainSchedulingParam(apvts.getRawParameterValue("GAIN_SCHEDULING")),
+      polyphonyParam(apvts.getRawParameterValue("POLYPHONY")),
+      unisonParam(apvts.getRawParameterValue("UNISON")),
+      unisonDetuneParam(apvts.getRawParameterValue("UNISON_DETUNE")),
+      unisonWidthParam(apvts.getRawParameterValue("UNISON_WIDTH")),
+      mxParam(apvts.getRawParameterValue("MX")), //
       myParam(apvts.getRawParameterValue("MY")),
       mzParam(apvts.getRawParameterValue("MZ")),
       cxParam(apvts.getRawParameterValue("CX")),
       cyParam(apvts.getRawParameterValue("CY")),
       czParam(apvts.getRawParameterValue("CZ"))
-      , tamingParam(apvts.getRawParameterValue("TAMING"))
+      , tamingParam(apvts.getRawParameterValue("TAMING")),
+      integratorParam(apvts.getRawParameterValue("INTEGRATOR")),
+      warmStartParam(apvts.getRawParameterValue("WARM_START"))
 #endif
 {
-    dtTarget = timestepParam->load();
+    effectiveTimestep = timestepParam->load();
+    displayedTimestep = effectiveTimestep;
     factoryPresets = FactoryPresets::getAvailablePresets();
     apvts.addParameterListener("MOD_TARGET", this); // Example, can add more if needed
+
+    for (int slot = 0; slot < numModulationSlots; ++slot)
+        modAmountParams[(size_t) slot] = apvts.getRawParameterValue(ModulationRouter::getAmountParameterID(slot));
 }
 
 
@@ -171,19 +212,263 @@ void LorenzAudioProcessor::changeProgramName (int index, const juce::String& new
     // You could implement user-renamable presets here if desired.
 }
 
+void LorenzAudioProcessor::updateParameterSnapshot()
+{
+    // The only place the audio thread loads the parameter atomics. Everything
+    // downstream reads the snapshot.
+    parameters.sigma = sigmaParam->load();
+    parameters.rho = rhoParam->load();
+    parameters.beta = betaParam->load();
+    parameters.mx = mxParam->load();
+    parameters.my = myParam->load();
+    parameters.mz = mzParam->load();
+    parameters.cx = cxParam->load();
+    parameters.cy = cyParam->load();
+    parameters.cz = czParam->load();
+    parameters.taming = tamingParam->load();
+    parameters.timestep = timestepParam->load();
+    parameters.integrator = static_cast<int>(integratorParam->load());
+    parameters.warmStart = static_cast<int>(warmStartParam->load());
+
+    parameters.levelX = juce::Decibels::decibelsToGain(levelXParam->load());
+    parameters.panX = panXParam->load();
+    parameters.levelY = juce::Decibels::decibelsToGain(levelYParam->load());
+    parameters.panY = panYParam->load();
+    parameters.levelZ = juce::Decibels::decibelsToGain(levelZParam->load());
+    parameters.panZ = panZParam->load();
+    parameters.outputLevel = juce::Decibels::decibelsToGain(outputLevelParam->load());
+
+    parameters.attack = attackParam->load();
+    parameters.decay = decayParam->load();
+    parameters.sustain = sustainParam->load();
+    parameters.release = releaseParam->load();
+
+    for (int slot = 0; slot < numModulationSlots; ++slot)
+        parameters.modAmount[slot] = modAmountParams[(size_t) slot]->load();
+    parameters.lfo1Rate = lfo1RateParam->load();
+    parameters.lfo1Shape = static_cast<int>(lfo1ShapeParam->load());
+    parameters.lfo2Rate = lfo2RateParam->load();
+    parameters.lfo2Shape = static_cast<int>(lfo2ShapeParam->load());
+    parameters.modEnvAttack = modEnvAttackParam->load();
+    parameters.modEnvDecay = modEnvDecayParam->load();
+    parameters.modEnvSustain = modEnvSustainParam->load();
+    parameters.modEnvRelease = modEnvReleaseParam->load();
+
+    parameters.targetFrequency = targetFrequencyParam->load();
+    parameters.kp = kpParam->load();
+    parameters.ki = kiParam->load();
+    parameters.kd = kdParam->load();
+    parameters.pidInterval = pidIntervalParam->load();
+    parameters.pitchSource = static_cast<int>(pitchSourceParam->load());
+    parameters.pitchHop = 256 << juce::jlimit(0, 3, static_cast<int>(pitchHopParam->load()));
+    parameters.pitchDetector = static_cast<int>(pitchDetectorParam->load());
+    parameters.gainScheduling = gainSchedulingParam->load() > 0.5f;
+
+    parameters.polyphony = static_cast<int>(polyphonyParam->load());
+    parameters.unisonCopies = static_cast<int>(unisonParam->load()) + 1;
+    parameters.unisonDetune = unisonDetuneParam->load();
+    parameters.unisonWidth = unisonWidthParam->load();
+}
+
 void LorenzAudioProcessor::resetSmoothedValues()
 {
     // This function forces an immediate update of all smoothed values,
     // bypassing the ramp. This is crucial when loading a new state or resetting.
-    smoothedLevelX.setCurrentAndTargetValue (juce::Decibels::decibelsToGain (levelXParam->load()));
-    smoothedPanX.setCurrentAndTargetValue (panXParam->load());
-    smoothedLevelY.setCurrentAndTargetValue (juce::Decibels::decibelsToGain (levelYParam->load()));
-    smoothedPanY.setCurrentAndTargetValue (panYParam->load());
-    smoothedLevelZ.setCurrentAndTargetValue (juce::Decibels::decibelsToGain (levelZParam->load()));
-    smoothedPanZ.setCurrentAndTargetValue (panZParam->load());
-    smoothedOutputLevel.setCurrentAndTargetValue (juce::Decibels::decibelsToGain (outputLevelParam->load()));
-
+    updateParameterSnapshot();
+
+    smoothedLevelX.setCurrentAndTargetValue (parameters.levelX);
+    smoothedPanX.setCurrentAndTargetValue (parameters.panX);
+    smoothedLevelY.setCurrentAndTargetValue (parameters.levelY);
+    smoothedPanY.setCurrentAndTargetValue (parameters.panY);
+    smoothedLevelZ.setCurrentAndTargetValue (parameters.levelZ);
+    smoothedPanZ.setCurrentAndTargetValue (parameters.panZ);
+    smoothedOutputLevel.setCurrentAndTargetValue (parameters.outputLevel);
+
+    mixerGains = getCurrentMixerGains();
+    mixerRamping = false;
+    samplesUntilMixerTick = 0;
+    modulationClock.restart();
+
+    lorenzOsc.setParameters(parameters);
     lorenzOsc.updateParameters();
+    unisonStack.setParameters(parameters);
+    unisonStack.setTimestep(parameters.timestep);
+    unisonStack.updateParameters();
+}
+
+LorenzAudioProcessor::MixerGains LorenzAudioProcessor::computeMixerGains(float levelX, float panX, float levelY, float panY,
+                                                                         float levelZ, float panZ, float outputLevel)
+{
+    // Constant power panning, with the scale and level of each variable and the
+    // master output level folded into a single gain per variable and channel.
+    const auto panAngle = [] (float pan) { return (pan + 1.0f) * juce::MathConstants<float>::pi * 0.25f; };
+
+    const float gainX = xScale * levelX * outputLevel;
+    const float gainY = yScale * levelY * outputLevel;
+    const float gainZ = zScale * levelZ * outputLevel;
+
+    return { gainX * juce::dsp::FastMathApproximations::cos(panAngle(panX)),
+             gainX * juce::dsp::FastMathApproximations::sin(panAngle(panX)),
+             gainY * juce::dsp::FastMathApproximations::cos(panAngle(panY)),
+             gainY * juce::dsp::FastMathApproximations::sin(panAngle(panY)),
+             gainZ * juce::dsp::FastMathApproximations::cos(panAngle(panZ)),
+             gainZ * juce::dsp::FastMathApproximations::sin(panAngle(panZ)) };
+}
+
+LorenzAudioProcessor::MixerGains LorenzAudioProcessor::getNextMixerGains()
+{
+    return computeMixerGains(smoothedLevelX.getNextValue(), smoothedPanX.getNextValue(),
+                             smoothedLevelY.getNextValue(), smoothedPanY.getNextValue(),
+                             smoothedLevelZ.getNextValue(), smoothedPanZ.getNextValue(),
+                             smoothedOutputLevel.getNextValue());
+}
+
+LorenzAudioProcessor::MixerGains LorenzAudioProcessor::getCurrentMixerGains() const
+{
+    return computeMixerGains(smoothedLevelX.getCurrentValue(), smoothedPanX.getCurrentValue(),
+                             smoothedLevelY.getCurrentValue(), smoothedPanY.getCurrentValue(),
+                             smoothedLevelZ.getCurrentValue(), smoothedPanZ.getCurrentValue(),
+                             smoothedOutputLevel.getCurrentValue());
+}
+
+bool LorenzAudioProcessor::updateModulation()
+{
+    // Advance the modulators by one control tick. The LFOs are centred on zero.
+    ModulationRouter::SourceValues sources {};
+    sources[(size_t) ModulationRouter::Source::LFO1] = 2.0f * lfo1.process() - 1.0f;
+    sources[(size_t) ModulationRouter::Source::LFO2] = 2.0f * lfo2.process() - 1.0f;
+    sources[(size_t) ModulationRouter::Source::ModEnvelope] = modEnvelope.process();
+    sources[(size_t) ModulationRouter::Source::CC1] = lastCC01Value;
+    sources[(size_t) ModulationRouter::Source::Velocity] = lastVelocity;
+    sources[(size_t) ModulationRouter::Source::Aftertouch] = lastAftertouch;
+
+    // The modulated values are handed to the oscillator, so the parameters
+    // themselves keep the user's base values. Once the matrix goes idle, the
+    // zero offsets are sent once and the oscillator is left alone.
+    const bool wasActive = modulationActive;
+    modulationActive = modulationRouter.computeOffsets(parameters, sources, modulationOffsets);
+
+    if (! modulationActive && ! wasActive)
+        return false;
+
+    lorenzOsc.setModulation(modulationOffsets);
+    unisonStack.setModulation(modulationOffsets);
+    return true;
+}
+
+float LorenzAudioProcessor::getPastTimestep(int numUpdates) const
+{
+    const int size = static_cast<int>(timestepHistory.size());
+    const int index = (timestepHistoryIndex - 1 - juce::jlimit(0, size - 1, numUpdates) + size) % size;
+    const float timestep = timestepHistory[(size_t) index];
+
+    // Before the history has filled, the oldest known timestep is the current one
+    return timestep > 0.0f ? timestep : lorenzOsc.getTimestep();
+}
+
+void LorenzAudioProcessor::updateFrequencyTracking(float intervalSeconds)
+{
+    // The timestep the oscillator ran with at the end of the interval just
+    // ended. It ramps to the controller's target over the smoothing time, so
+    // after a jump it lags parameters.timestep for a while.
+    const int historySize = static_cast<int>(timestepHistory.size());
+    const float previousTimestep = timestepHistory[(size_t) ((timestepHistoryIndex - 1 + historySize) % historySize)];
+    const float timestep = lorenzOsc.getTimestep();
+
+    timestepHistory[(size_t) timestepHistoryIndex] = timestep;
+    timestepHistoryIndex = (timestepHistoryIndex + 1) % historySize;
+
+    frequencyTracker.predict(intervalSeconds);
+
+    // The frequency is proportional to the timestep, so the tracker follows the
+    // controller's own changes as the oscillator actually makes them, ramp included.
+    if (previousTimestep > 0.0f)
+        frequencyTracker.scaleFrequency(timestep / previousTimestep);
+
+    // An estimate describes the signal latencySamples ago, so it is paired with
+    // the timestep that was running then, to learn the sensitivity. The tracker
+    // is given the estimate as it would be at the current timestep: the
+    // controller's own changes since then are already known and must not be
+    // measured again. Only the estimates the tracker trusts reach the
+    // sensitivity estimator, so a dropout or an octave error cannot move the gains.
+    auto addEstimate = [this, intervalSeconds, timestep] (float frequency, float confidence, double latencySamples)
+    {
+        const auto ageSeconds = static_cast<float>(latencySamples / processSampleRate);
+        const float pastTimestep = getPastTimestep(juce::roundToInt(ageSeconds / intervalSeconds));
+
+        if (frequencyTracker.addMeasurement(frequency * timestep / pastTimestep, confidence, ageSeconds))
+            sensitivityEstimator.addObservation(pastTimestep, frequency);
+    };
+
+    if (usingPoincareSection)
+    {
+        // The section estimate changes at each crossing; an unchanged value is not a new measurement.
+        if (const float frequency = poincareEstimator.getFrequency(); frequency != lastSectionFrequency)
+        {
+            lastSectionFrequency = frequency;
+            addEstimate(frequency, 1.0f, poincareEstimator.getLatencySamples());
+        }
+    }
+    else if (pitchAnalyser.getLatestEstimateTime() != lastTrackedEstimateTime)
+    {
+        lastTrackedEstimateTime = pitchAnalyser.getLatestEstimateTime();
+        addEstimate(pitchAnalyser.getLatestEstimate(), pitchAnalyser.getLatestConfidence(), pitchAnalyser.getLatencySamples());
+    }
+}
+
+void LorenzAudioProcessor::updatePitchControl(float intervalSeconds)
+{
+    // Without a tracked pitch the timestep is held where it is, rather than
+    // driven by an error of the full target frequency.
+    const float measured = frequencyTracker.getFrequency();
+    if (measured <= 0.0f)
+        return;
+
+    const float gainScale = parameters.gainScheduling ? sensitivityEstimator.getGainScale() : 1.0f;
+
+    pidController.setGains(parameters.kp * gainScale, parameters.ki * gainScale, parameters.kd * gainScale);
+
+    const float adjustment = pidController.process(parameters.targetFrequency, measured, intervalSeconds);
+
+    effectiveTimestep += adjustment;
+    effectiveTimestep = timestepRangedParam->getNormalisableRange().snapToLegalValue(effectiveTimestep); // Clamp to the parameter's full legal range
+
+    // The oscillator follows the controlled timestep from the next segment on.
+    // The parameter is left alone; the editor shows displayedTimestep instead.
+    lorenzOsc.setTimestep(effectiveTimestep);
+    parameters.timestep = effectiveTimestep;
+    displayedTimestep.store(effectiveTimestep, std::memory_order_relaxed);
+}
+
+void LorenzAudioProcessor::jumpToPredictedTimestep(bool snap)
+{
+    // Start the note at the timestep expected to give its frequency, when the
+    // table for the current attractor is ready. The PID only trims the rest.
+    const float predicted = timestepPredictor.predictTimestep(parameters.targetFrequency);
+    if (predicted <= 0.0f)
+        return;
+
+    effectiveTimestep = predicted;
+    parameters.timestep = predicted;
+    displayedTimestep.store(predicted, std::memory_order_relaxed);
+    lorenzOsc.setTimestep(predicted);
+    unisonStack.setTimestep(predicted);
+
+    // A new note starts right at the predicted pitch; a legato change glides to it.
+    if (snap)
+    {
+        lorenzOsc.updateParameters();
+        unisonStack.updateParameters();
+    }
+}
+
+bool LorenzAudioProcessor::getWarmStartState(int phase, LorenzKernels::State<double>& state)
+{
+    if (parameters.warmStart == 0 || ! warmStartCache.isReady())
+        return false;
+
+    state = parameters.warmStart == 2 ? warmStartCache.getRandomState() : warmStartCache.getState(phase);
+    return true;
 }
 
 void LorenzAudioProcessor::resetAudioEngineState()
@@ -194,39 +479,64 @@ void LorenzAudioProcessor::resetAudioEngineState()
     const juce::ScopedLock audioCallbackLock (getCallbackLock());
 
     lorenzOsc.reset();
+    unisonStack.restart();
+    voicePool.reset();
     pidController.reset();
-
-    // Reset dtTarget to the current slider value, not the last controlled value
-    dtTarget = timestepRangedParam->getNormalisableRange().convertFrom0to1(timestepParam->load());
-    *timestepParam = dtTarget;
+    sensitivityEstimator.reset();
+    frequencyTracker.reset();
+    timestepHistory.fill(0.0f);
+    timestepHistoryIndex = 0;
+
+    // The controller starts over from the current TIMESTEP value. The raw
+    // parameter value is already in seconds, not normalised.
+    effectiveTimestep = timestepParam->load();
+    displayedTimestep = effectiveTimestep;
     measuredFrequency = 0.0f;
 
     // Reset the high-pass filter's state and the pitch analysis buffer
     for (int i = 0; i < hpf_prevInput.size(); ++i) hpf_prevInput.set(i, 0.0f);
     for (int i = 0; i < hpf_prevOutput.size(); ++i) hpf_prevOutput.set(i, 0.0f);
-    analysisBuffer.clear();
+    pitchAnalyser.reset();
+    poincareEstimator.reset();
     resetSmoothedValues();
 }
 //==============================================================================
 void LorenzAudioProcessor::prepareToPlay (double sampleRate, int samplesPerBlock)
 {
+    lorenzOsc.setControlInterval(controlInterval);
     lorenzOsc.prepareToPlay(sampleRate);
-
-    // Pass the parameter pointers to the oscillator.
-    lorenzOsc.setParameters(sigmaParam, rhoParam, betaParam, mxParam, myParam, mzParam, cxParam, cyParam, czParam, tamingParam);
-    lorenzOsc.setTimestep(timestepParam);
+    unisonStack.prepare(sampleRate, samplesPerBlock, controlInterval);
 
     // Prepare ADSR
     ampAdsr.setSampleRate(sampleRate);
 
+    // Every voice is allocated here; playing and stealing voices never allocate
+    voicePool.prepare(sampleRate, samplesPerBlock, controlInterval);
+
+    // The modulators are advanced once per control tick
+    lfo1.prepareToPlay(sampleRate / controlInterval);
+    lfo2.prepareToPlay(sampleRate / controlInterval);
+    modEnvelope.prepareToPlay(sampleRate / controlInterval);
+
     // Calculate how many audio samples to wait before generating the next point for the GUI
     pointGenerationInterval = static_cast<int>(sampleRate / pointsPerSecond);
 
-    // Prepare frequency detector
-    const int pitchBufferSize = PITCHBUFFERSIZE;
-    pitchDetector.setBufferSize (pitchBufferSize);
-    pitchDetector.setSampleRate (sampleRate);
-    analysisBuffer.setSize(1, pitchBufferSize);
+    // Prepare frequency detector. It runs on its own thread, except when
+    // rendering offline, where it must not fall behind the audio. Hosts say
+    // they render offline before preparing, so this is decided here only.
+    pitchAnalyser.prepare (sampleRate, PITCHBUFFERSIZE, isNonRealtime());
+
+    // Builds the timestep -> frequency table in the background
+    const auto& timestepRange = timestepRangedParam->getNormalisableRange();
+    timestepPredictor.prepare(sampleRate, PITCHBUFFERSIZE, timestepRange.start, timestepRange.end);
+
+    // Takes the note start states on the attractor in the background
+    warmStartCache.prepare(sampleRate);
+    poincareEstimator.prepare(sampleRate);
+
+    // Scratch buffer for the oscillator's X, Y and Z outputs, the pitch-source
+    // signal, and the unison copies' X, Y and Z sums for the left and right channels
+    oscBuffer.setSize(oscBufferChannels, samplesPerBlock);
 
     // Initialize HPF state arrays to match the number of output channels
     hpf_prevInput.resize(getTotalNumOutputChannels());
@@ -235,17 +545,20 @@ void LorenzAudioProcessor::prepareToPlay (double sampleRate, int samplesPerBlock
 
     // Prepare PID controller
     pidController.setIntegralLimits(-0.001f, 0.001f);
-    timeSinceLastPidUpdate = 0.0;
+    pidClock.restart();
+    modulationClock.setInterval(controlInterval);
 
-    // Prepare smoothed values with a ramp length
+    // Prepare smoothed values with a ramp length. They are advanced once per
+    // control tick, so they run at the control rate.
     const double rampTimeSeconds = 0.05;
-    smoothedLevelX.reset (sampleRate, rampTimeSeconds);
-    smoothedPanX.reset (sampleRate, rampTimeSeconds);
-    smoothedLevelY.reset (sampleRate, rampTimeSeconds);
-    smoothedPanY.reset (sampleRate, rampTimeSeconds);
-    smoothedLevelZ.reset (sampleRate, rampTimeSeconds);
-    smoothedPanZ.reset (sampleRate, rampTimeSeconds);
-    smoothedOutputLevel.reset (sampleRate, rampTimeSeconds);
+    const double controlRate = sampleRate / controlInterval;
+    smoothedLevelX.reset (controlRate, rampTimeSeconds);
+    smoothedPanX.reset (controlRate, rampTimeSeconds);
+    smoothedLevelY.reset (controlRate, rampTimeSeconds);
+    smoothedPanY.reset (controlRate, rampTimeSeconds);
+    smoothedLevelZ.reset (controlRate, rampTimeSeconds);
+    smoothedPanZ.reset (controlRate, rampTimeSeconds);
+    smoothedOutputLevel.reset (controlRate, rampTimeSeconds);
     resetSmoothedValues(); // Initialize them to current parameter values
 }
 
@@ -253,6 +566,10 @@ void LorenzAudioProcessor::releaseResources()
 {
     // When playback stops, you can use this as an opportunity to free up any
     // spare memory, etc.
+    pitchAnalyser.release();
+    timestepPredictor.release();
+    warmStartCache.release();
+    voicePool.release();
 }
 
 #ifndef JucePlugin_PreferredChannelConfigurations
@@ -313,6 +630,147 @@ void LorenzAudioProcessor::highPassFilter(juce::AudioBuffer<float>& buffer, floa
     }
 }
 
+bool LorenzAudioProcessor::settleHighPassFilter()
+{
+    for (int channel = 0; channel < hpf_prevOutput.size(); ++channel)
+        if (std::abs(hpf_prevInput[channel]) > idleThreshold || std::abs(hpf_prevOutput[channel]) > idleThreshold)
+            return false;
+
+    // Clears what is left of the tail, denormals included
+    for (int i = 0; i < hpf_prevInput.size(); ++i) hpf_prevInput.set(i, 0.0f);
+    for (int i = 0; i < hpf_prevOutput.size(); ++i) hpf_prevOutput.set(i, 0.0f);
+    return true;
+}
+
+void LorenzAudioProcessor::setTargetNote(int noteNumber)
+{
+    // Convert the frequency to a normalized value (0.0 to 1.0) and set the parameter.
+    // This ensures the GUI is notified of the change.
+    const float newFreq = (float) juce::MidiMessage::getMidiNoteInHertz(noteNumber);
+    auto normalizedFreq = targetFrequencyRangedParam->getNormalisableRange().convertTo0to1(newFreq);
+    targetFrequencyRangedParam->setValueNotifyingHost(normalizedFreq);
+    parameters.targetFrequency = targetFrequencyParam->load();
+}
+
+void LorenzAudioProcessor::handleVoiceNote(const juce::MidiMessage& msg)
+{
+    const int noteNumber = msg.getNoteNumber();
+
+    // The note stack only tells when the modulation envelope starts and releases:
+    // it is shared by all the voices, and follows the first note of a phrase.
+    if (msg.isNoteOn())
+    {
+        lastVelocity = msg.getFloatVelocity();
+
+        if (noteStack.isEmpty())
+            modEnvelope.noteOn();
+
+        if (!noteStack.contains(noteNumber))
+            noteStack.add(noteNumber);
+
+        // Each voice starts at the timestep predicted for its own note, or at
+        // the TIMESTEP parameter until the table is ready, and its PID trims the rest.
+        const float frequency = (float) juce::MidiMessage::getMidiNoteInHertz(noteNumber);
+        const float predicted = timestepPredictor.predictTimestep(frequency);
+
+        auto startState = LorenzKernels::initialState<double>;
+        getWarmStartState(0, startState);
+
+        voicePool.noteOn(noteNumber, frequency, predicted > 0.0f ? predicted : timestepParam->load(), startState);
+    }
+    else
+    {
+        noteStack.removeFirstMatchingValue(noteNumber);
+        voicePool.noteOff(noteNumber);
+
+        if (noteStack.isEmpty())
+            modEnvelope.noteOff();
+    }
+}
+
+void LorenzAudioProcessor::handleMidiMessage(const juce::MidiMessage& msg)
+{
+    if (polyphonic && (msg.isNoteOn() || msg.isNoteOff()))
+    {
+        handleVoiceNote(msg);
+    }
+    else if (msg.isNoteOn())
+    {
+        const int noteNumber = msg.getNoteNumber();
+        lastVelocity = msg.getFloatVelocity();
+        bool retriggered = false;
+
+        // Add note to the stack if it's not already there
+        if (!noteStack.contains(noteNumber))
+            noteStack.add(noteNumber);
+
+        if (currentNote != noteNumber)
+        {
+            currentNote = noteNumber;
+            // If this is the first note being played, trigger the attack.
+            // Otherwise, we just change frequency (legato style).
+            if (noteStack.size() == 1)
+            {
+                resetAudioEngineState();
+
+                // Start on the attractor rather than replaying its transient.
+                // The unison copies take the next phases, so they start apart.
+                LorenzKernels::State<double> warmState;
+                if (getWarmStartState(0, warmState))
+                    lorenzOsc.setState(warmState);
+
+                for (int copy = 0; copy < UnisonStack::maxCopies - 1; ++copy)
+                    if (getWarmStartState(copy + 1, warmState))
+                        unisonStack.setState(copy, warmState);
+
+                ampAdsr.noteOn();
+                modEnvelope.noteOn();
+                retriggered = true;
+            }
+        }
+
+        // Update target frequency based on the new note
+        setTargetNote(currentNote);
+        jumpToPredictedTimestep(retriggered);
+    }
+    else if (msg.isNoteOff())
+    {
+        const int noteNumber = msg.getNoteNumber();
+        noteStack.removeFirstMatchingValue(noteNumber);
+
+        // If the released note was the one playing, trigger release.
+        if (currentNote == noteNumber)
+        {
+            // If other notes are still held, switch to the last one on the stack.
+            if (noteStack.size() > 0)
+            {
+                currentNote = noteStack.getLast();
+                setTargetNote(currentNote);
+                jumpToPredictedTimestep(false);
+            }
+            else // Otherwise, trigger release and reset note state.
+            {
+                ampAdsr.noteOff();
+                modEnvelope.noteOff();
+                currentNote = -1;
+            }
+        }
+    }
+    else if (msg.isController() && msg.getControllerNumber() == 1)
+    {
+        // Store the last CC01 value, normalized to 0.0 - 1.0
+        lastCC01Value = msg.getControllerValue() / 127.0f;
+    }
+    else if (msg.isChannelPressure())
+    {
+        lastAftertouch = msg.getChannelPressureValue() / 127.0f;
+    }
+    else if (msg.isAftertouch() && msg.getNoteNumber() == currentNote)
+    {
+        lastAftertouch = msg.getAfterTouchValue() / 127.0f;
+    }
+}
+
 void LorenzAudioProcessor::processBlock (juce::AudioBuffer<float>& buffer, juce::MidiBuffer& midiMessages)
 {
     juce::ScopedNoDenormals noDenormals;
@@ -326,90 +784,50 @@ void LorenzAudioProcessor::processBlock (juce::AudioBuffer<float>& buffer, juce:
     // when they first compile a plugin.
     // As our oscillator is generating the signal, we can clear the buffer first.
 
+    // --- Load this block's parameters ---
+    updateParameterSnapshot();
+    timestepPredictor.setAttractor(parameters);
+    warmStartCache.setAttractor(parameters);
+
     // --- Update ADSR Parameters ---
-    ampAdsrParams.attack = attackParam->load();
-    ampAdsrParams.decay = decayParam->load();
-    ampAdsrParams.sustain = sustainParam->load();
-    ampAdsrParams.release = releaseParam->load();
+    ampAdsrParams.attack = parameters.attack;
+    ampAdsrParams.decay = parameters.decay;
+    ampAdsrParams.sustain = parameters.sustain;
+    ampAdsrParams.release = parameters.release;
     ampAdsr.setParameters(ampAdsrParams);
 
-    // --- Modulation Setup ---
-    const auto modAmount = modAmountParam->load();
-    const auto modTarget = static_cast<int>(modTargetParam->load());
-    // Create a map for easy lookup of parameters by their index in the choice parameter
-    const std::map<int, std::atomic<float>*> modTargetMap = { {1, sigmaParam}, {2, rhoParam}, {3, betaParam}, {4, mxParam}, {5, myParam}, {6, mzParam}, {7, cxParam}, {8, cyParam}, {9, czParam}, {10, tamingParam} };
-    // Create a map to get the parameter ID string from the choice index
-    const std::map<int, juce::String> modTargetIdMap = { {1, "SIGMA"}, {2, "RHO"}, {3, "BETA"}, {4, "MX"}, {5, "MY"}, {6, "MZ"}, {7, "CX"}, {8, "CY"}, {9, "CZ"}, {10, "TAMING"} };
-
-
-    // --- MIDI Event Handling ---
-    for (const auto metadata : midiMessages)
+    // --- Update Modulator Parameters ---
+    lfo1.setFrequency(parameters.lfo1Rate);
+    lfo1.setWaveform(static_cast<LFO::Waveform>(parameters.lfo1Shape));
+    lfo2.setFrequency(parameters.lfo2Rate);
+    lfo2.setWaveform(static_cast<LFO::Waveform>(parameters.lfo2Shape));
+    modEnvelope.setParameters({ parameters.modEnvAttack, parameters.modEnvDecay, parameters.modEnvSustain, parameters.modEnvRelease });
+
+    // --- Voice mode ---
+    // Switching between the monophonic and polyphonic modes cuts every note:
+    // the held notes belong to the engine that was playing them.
+    if (const bool polyphonicMode = parameters.polyphony > 0; polyphonicMode != polyphonic)
     {
-        const auto msg = metadata.getMessage();
-        if (msg.isNoteOn())
-        {
-            const int noteNumber = msg.getNoteNumber();
-            
-            // Add note to the stack if it's not already there
-            if (!noteStack.contains(noteNumber))
-                noteStack.add(noteNumber);
+        polyphonic = polyphonicMode;
+        voicePool.reset();
+        voicePool.setModulation(modulationOffsets);
+        ampAdsr.reset();
+        modEnvelope.noteOff();
+        noteStack.clear();
+        currentNote = -1;
+    }
 
-            if (currentNote != noteNumber)
-            {
-                currentNote = noteNumber;
-                // If this is the first note being played, trigger the attack.
-                // Otherwise, we just change frequency (legato style).
-                if (noteStack.size() == 1)
-                {
-                    resetAudioEngineState();
-                    ampAdsr.noteOn();
-                }
-            }
-            
-            // Update target frequency based on the new note
-            const float newFreq = (float) juce::MidiMessage::getMidiNoteInHertz(currentNote);
-            // Convert the frequency to a normalized value (0.0 to 1.0) and set the parameter.
-            // This ensures the GUI is notified of the change.
-            auto normalizedFreq = targetFrequencyRangedParam->getNormalisableRange().convertTo0to1(newFreq);
-            targetFrequencyRangedParam->setValueNotifyingHost(normalizedFreq);
-        }
-        else if (msg.isNoteOff())
-        {
-            const int noteNumber = msg.getNoteNumber();
-            noteStack.removeFirstMatchingValue(noteNumber);
+    voicePool.setNumVoices(parameters.polyphony == 1 ? 8 : VoicePool::maxVoices);
+    voicePool.setParameters(parameters, ampAdsrParams);
 
-            // If the released note was the one playing, trigger release.
-            if (currentNote == noteNumber)
-            {
-                // If other notes are still held, switch to the last one on the stack.
-                if (noteStack.size() > 0)
-                {
-                    currentNote = noteStack.getLast();
-                    const float newFreq = (float) juce::MidiMessage::getMidiNoteInHertz(currentNote);
-                    auto normalizedFreq = targetFrequencyRangedParam->getNormalisableRange().convertTo0to1(newFreq);
-                    targetFrequencyRangedParam->setValueNotifyingHost(normalizedFreq);
-                }
-                else // Otherwise, trigger release and reset note state.
-                {
-                    ampAdsr.noteOff();
-                    currentNote = -1;
-                }
-            }
-        }
-        else if (msg.isController() && msg.getControllerNumber() == 1)
-        {
-            // Store the last CC01 value, normalized to 0.0 - 1.0
-            lastCC01Value = msg.getControllerValue() / 127.0f;
-            //std::cout << "CC01: " << lastCC01Value << std::endl;
-        }
-    }
-    midiMessages.clear(); // We've processed the MIDI messages
+    unisonStack.setNumCopies(polyphonic ? 1 : parameters.unisonCopies);
+    unisonStack.setParameters(parameters);
+    const bool unison = unisonStack.isActive();
+    const float leadLeftGain = unisonStack.getLeadLeftGain();
+    const float leadRightGain = unisonStack.getLeadRightGain();
 
     buffer.clear();
 
-    // Create a temporary buffer to hold the signal for pitch analysis for the current block.
-    juce::AudioBuffer<float> pitchAnalysisBlock(1, buffer.getNumSamples());
-
     for (auto i = totalNumInputChannels; i < totalNumOutputChannels; ++i)
         buffer.clear (i, 0, buffer.getNumSamples());
 
@@ -423,171 +841,284 @@ void LorenzAudioProcessor::processBlock (juce::AudioBuffer<float>& buffer, juce:
         resetAudioEngineState();
     }
 
-    // Load parameter values.
-    const float levelX = juce::Decibels::decibelsToGain(apvts.getRawParameterValue("LEVEL_X")->load());
-    const float panX = panXParam->load();
-    const float levelY = juce::Decibels::decibelsToGain(apvts.getRawParameterValue("LEVEL_Y")->load());
-    const float panY = panYParam->load();
-    const float levelZ = juce::Decibels::decibelsToGain(apvts.getRawParameterValue("LEVEL_Z")->load());
-    const float panZ = panZParam->load();
-    const float outputLevel = juce::Decibels::decibelsToGain(outputLevelParam->load());
-    const float targetFrequency = targetFrequencyParam->load();
-    const float pidUpdateIntervalSeconds = pidIntervalParam->load();
-    
+    // --- Idle ---
+    // Once no note sounds and the output filter's tail has died away, the block
+    // is silence: the attractors' states are frozen, the pitch analysis and the
+    // controller wait, and only the cleared buffer goes out. Any MIDI in the
+    // block wakes the engine from its first sample. The frozen states are not
+    // resumed: in mono the first note-on resets the oscillator, the unison stack
+    // and the analysers, and in poly a voice resets its oscillator when it starts.
+    const bool engineSilent = polyphonic ? ! voicePool.isAnyVoiceActive() : ! ampAdsr.isActive();
+    if (engineSilent && midiMessages.isEmpty() && settleHighPassFilter())
+    {
+        timestepControlled.store(false, std::memory_order_relaxed);
+        return;
+    }
+
     // Set target values for smoothed parameters at the start of the block
-    smoothedLevelX.setTargetValue (levelX);
-    smoothedPanX.setTargetValue (panX);
-    smoothedLevelY.setTargetValue (levelY);
-    smoothedPanY.setTargetValue (panY);
-    smoothedLevelZ.setTargetValue (levelZ);
-    smoothedPanZ.setTargetValue (panZ);
-    smoothedOutputLevel.setTargetValue (outputLevel);
-    
-    // The state variables can have a large range, so we scale them down.
-    const float xScale = 0.025f;
-    const float yScale = 0.025f;
-    const float zScale = 0.0125f;
+    smoothedLevelX.setTargetValue (parameters.levelX);
+    smoothedPanX.setTargetValue (parameters.panX);
+    smoothedLevelY.setTargetValue (parameters.levelY);
+    smoothedPanY.setTargetValue (parameters.panY);
+    smoothedLevelZ.setTargetValue (parameters.levelZ);
+    smoothedPanZ.setTargetValue (parameters.panZ);
+    smoothedOutputLevel.setTargetValue (parameters.outputLevel);
+
+    pitchAnalyser.setHopSize(parameters.pitchHop);
+    pitchAnalyser.setDetector(static_cast<PitchDetector::Type>(parameters.pitchDetector));
+
+    // The Poincaré sections measure the period from the raw attractor state,
+    // so the audio analyser is idle (and starts over when it is used again).
+    const bool usePoincareSection = parameters.pitchSource >= 3;
+    if (usePoincareSection != usingPoincareSection)
+    {
+        usingPoincareSection = usePoincareSection;
+        pitchAnalyser.reset();
+        poincareEstimator.reset();
+
+        // The two kinds of source can measure different multiples of the
+        // attractor's rate, so what was learnt no longer applies.
+        sensitivityEstimator.reset();
+        frequencyTracker.reset();
+    }
 
-    const double sampleDurationSeconds = 1.0 / processSampleRate;
+    if (parameters.pitchSource == 3)
+        poincareEstimator.setSection(parameters.rho + modulationOffsets.rho - 1.0f, poincareHysteresis);
+    else
+        poincareEstimator.setSection(0.0f, poincareHysteresis);
 
-    for (int sample = 0; sample < buffer.getNumSamples(); ++sample)
+    // The voices always measure their pitch on a section of their own state.
+    // A signal source is read as the section on the same coordinate.
+    if (polyphonic)
+    {
+        static constexpr int sectionAxes[] = { 0, 1, 2, 2, 0, 1 };
+        const int axis = sectionAxes[juce::jlimit(0, 5, parameters.pitchSource)];
+        voicePool.setSection(axis, axis == 2 ? parameters.rho + modulationOffsets.rho - 1.0f : 0.0f, poincareHysteresis);
+    }
+
+    // --- Render the block ---
+    const int numSamples = buffer.getNumSamples();
+    if (oscBuffer.getNumSamples() < numSamples)
+        oscBuffer.setSize(oscBufferChannels, numSamples, false, false, true);
+
+    auto* xData = oscBuffer.getWritePointer(0);
+    auto* yData = oscBuffer.getWritePointer(1);
+    auto* zData = oscBuffer.getWritePointer(2);
+    auto* pitchSourceData = oscBuffer.getWritePointer(3);
+    float* const unisonLeft[] = { oscBuffer.getWritePointer(4), oscBuffer.getWritePointer(5), oscBuffer.getWritePointer(6) };
+    float* const unisonRight[] = { oscBuffer.getWritePointer(7), oscBuffer.getWritePointer(8), oscBuffer.getWritePointer(9) };
+
+    // While the controller runs, the oscillator follows its timestep and the
+    // TIMESTEP parameter only gives each note its starting point. Notes start
+    // and stop the controller, so this is checked again after each MIDI event.
+    const auto updateTimestepControl = [this]
     {
-        // --- Apply Modulation ---
-        // This is done per-sample in case the CC value changes rapidly.
-        if (modTarget > 0 && modAmount != 0.0f)
+        const bool controllingTimestep = ! polyphonic && parameters.targetFrequency > 0.0f && ampAdsr.isActive();
+        timestepControlled.store(controllingTimestep, std::memory_order_relaxed);
+
+        if (controllingTimestep)
         {
-            // Find the parameter ID and the atomic float pointer using our maps
-            auto idIt = modTargetIdMap.find(modTarget);
-            auto paramIt = modTargetMap.find(modTarget);
+            parameters.timestep = effectiveTimestep;
+            lorenzOsc.setTimestep(effectiveTimestep);
+        }
 
-            if (idIt != modTargetIdMap.end() && paramIt != modTargetMap.end())
-            {
-                const juce::String& paramId = idIt->second;
-                auto* paramToMod = paramIt->second;
-                auto* rangedParam = static_cast<juce::RangedAudioParameter*>(apvts.getParameter(paramId));
-                const auto range = rangedParam->getNormalisableRange();
+        pitchAnalyser.setTargetFrequency(parameters.targetFrequency);
+    };
 
-                // Get the real-world (un-normalized) value by converting the normalized value back.
-                const float baseValue = range.convertFrom0to1(rangedParam->getValue());
-                const float modValue = modAmount * lastCC01Value; // Bipolar modulation value
+    updateTimestepControl();
+    lorenzOsc.setParameters(parameters);
 
-                float finalValue;
-                if (modValue >= 0.0f)
-                {
-                    // Modulate towards max
-                    finalValue = baseValue + modValue * (range.getRange().getEnd() - baseValue);
-                }
-                else // modValue < 0.0f
-                {
-                    // Modulate towards min
-                    finalValue = baseValue + modValue * (baseValue - range.getRange().getStart());
-                }
-                paramToMod->store(finalValue);
-            }
+    // The PID runs on whole-sample boundaries, so its interval is rounded to samples
+    pidClock.setInterval(juce::roundToInt(parameters.pidInterval * processSampleRate));
+    const float pidIntervalSeconds = static_cast<float>(pidClock.getInterval() / processSampleRate);
+
+    // The block is split at MIDI events, modulation ticks and PID updates. Each
+    // segment is rendered by the oscillator in one call, then mixed; the events,
+    // the modulation matrix and the controller update the oscillator between
+    // segments, so each of them takes effect on its own sample.
+    auto midiEvent = midiMessages.cbegin();
+
+    for (int start = 0; start < numSamples;)
+    {
+        if (midiEvent != midiMessages.cend() && (*midiEvent).samplePosition <= start)
+        {
+            for (; midiEvent != midiMessages.cend() && (*midiEvent).samplePosition <= start; ++midiEvent)
+                handleMidiMessage((*midiEvent).getMessage());
+
+            updateTimestepControl();
         }
 
-        // --- PID Controller (run at fixed interval, checked per-sample) ---
-        timeSinceLastPidUpdate += sampleDurationSeconds;
+        const int nextEvent = midiEvent != midiMessages.cend() ? juce::jmin((*midiEvent).samplePosition, numSamples) : numSamples;
+        int segmentLength = 0;
 
-        // Only run the PID controller if a note is being played (targetFrequency > 0)
-        // and the ADSR is not in its idle state.
-        if (targetFrequency > 0.0f && ampAdsr.isActive())
+        if (polyphonic)
         {
-            // Run the PID controller at a fixed interval
-            while (timeSinceLastPidUpdate >= pidUpdateIntervalSeconds)
-            {
-                // Update PID gains
-                pidController.setGains(kpParam->load(), kiParam->load(), kdParam->load());
+            // The voices render the whole span up to the next MIDI event in one
+            // batch, so the render workers are dispatched once per span. The
+            // modulation and pitch-lock updates inside it are scheduled instead,
+            // and each voice runs them on their own sample.
+            segmentLength = juce::jmin(nextEvent - start, voicePool.getMaxSpanLength());
 
-                // Calculate control adjustment using the fixed time step
-                const float adjustment = pidController.process(targetFrequency, measuredFrequency.load(), pidUpdateIntervalSeconds);
+            for (int offset = 0; offset < segmentLength;)
+            {
+                if (modulationClock.tick() && updateModulation())
+                    voicePool.scheduleModulation(offset, modulationOffsets);
 
-                dtTarget += adjustment;
-                dtTarget = timestepRangedParam->getNormalisableRange().snapToLegalValue(dtTarget); // Clamp to the parameter's full legal range
+                // Each sounding voice runs its own lock on its own note
+                if (pidClock.tick())
+                    voicePool.schedulePitchControl(offset, pidIntervalSeconds, timestepRangedParam->getNormalisableRange());
 
-                timeSinceLastPidUpdate -= pidUpdateIntervalSeconds;
+                const int step = std::min({ segmentLength - offset, modulationClock.getSamplesUntilTick(), pidClock.getSamplesUntilTick() });
+                modulationClock.advance(step);
+                pidClock.advance(step);
+                offset += step;
             }
-            // Update the parameter with the final calculated dtTarget
-            timestepRangedParam->setValueNotifyingHost(timestepRangedParam->getNormalisableRange().convertTo0to1(dtTarget));
+
+            // The voices come out already weighted by their own envelopes
+            voicePool.render(xData + start, yData + start, zData + start, segmentLength);
         }
+        else
+        {
+            if (modulationClock.tick())
+                updateModulation();
+
+            if (pidClock.tick())
+            {
+                // The tracker follows the pitch whether or not a note is playing,
+                // so it is up to date when the controller starts.
+                updateFrequencyTracking(pidIntervalSeconds);
+
+                // Only run the PID controller if a note is being played (targetFrequency > 0)
+                // and the ADSR is not in its idle state.
+                if (parameters.targetFrequency > 0.0f && ampAdsr.isActive())
+                    updatePitchControl(pidIntervalSeconds);
+            }
 
-        // We need a separate buffer for the pitch analysis signal
-        // to ensure it's pre-fader and pre-panner.
-        float pitchSourceSample = 0.0f;
-        auto [x, y, z] = lorenzOsc.getNextSample();
+            segmentLength = std::min({ nextEvent - start, modulationClock.getSamplesUntilTick(), pidClock.getSamplesUntilTick() });
+            lorenzOsc.renderBlock(xData + start, yData + start, zData + start, segmentLength);
+            modulationClock.advance(segmentLength);
+            pidClock.advance(segmentLength);
+        }
 
-        // --- Stability Guard ---
-        // If the oscillator becomes unstable, it can return non-finite values.
-        // We replace them with 0 to prevent them from corrupting the filter state.
-        if (!std::isfinite(x)) x = 0.0;
-        if (!std::isfinite(y)) y = 0.0;
-        if (!std::isfinite(z)) z = 0.0;
+        const int end = start + segmentLength;
 
-        // Push points to the FIFO at a controlled rate, not on every sample.
-        if (--samplesUntilNextPoint <= 0)
+        if (unison)
         {
-            pushPointToFifo({(float)x, (float)y, (float)z});
-            samplesUntilNextPoint = pointGenerationInterval;
+            float* left[] = { unisonLeft[0] + start, unisonLeft[1] + start, unisonLeft[2] + start };
+            float* right[] = { unisonRight[0] + start, unisonRight[1] + start, unisonRight[2] + start };
+            unisonStack.setTimestep(parameters.timestep);
+            unisonStack.render(left, right, segmentLength);
         }
 
-        // --- Pitch Source Selection ---
-        // Select the signal for pitch detection *before* level and pan are applied.
-        const int pitchSourceIndex = static_cast<int>(pitchSourceParam->load());
-        switch (pitchSourceIndex)
+        for (int sample = start; sample < end; ++sample)
         {
-            case 0: pitchSourceSample = static_cast<float>(x) * xScale; break;
-            case 1: pitchSourceSample = static_cast<float>(y) * yScale; break;
-            case 2: pitchSourceSample = static_cast<float>(z) * zScale; break;
-            default: pitchSourceSample = static_cast<float>(x) * xScale; break;
-        }
+            float x = xData[sample];
+            float y = yData[sample];
+            float z = zData[sample];
+
+            // --- Stability Guard ---
+            // If the oscillator becomes unstable, it can return non-finite values.
+            // We replace them with 0 to prevent them from corrupting the filter state.
+            if (!std::isfinite(x)) x = 0.0f;
+            if (!std::isfinite(y)) y = 0.0f;
+            if (!std::isfinite(z)) z = 0.0f;
+
+            // Push points to the FIFO at a controlled rate, not on every sample.
+            if (--samplesUntilNextPoint <= 0)
+            {
+                pushPointToFifo({x, y, z});
+                samplesUntilNextPoint = pointGenerationInterval;
+            }
+
+            // --- Pitch Source Selection ---
+            // Select the signal for pitch detection *before* level and pan are applied.
+            // It goes to a separate buffer, handed to the analyser after the segment.
+            // The voices measure their own pitch, so the sum is not analysed.
+            if (! polyphonic)
+            {
+                switch (parameters.pitchSource)
+                {
+                    case 0: pitchSourceData[sample] = x * xScale; break;
+                    case 1: pitchSourceData[sample] = y * yScale; break;
+                    case 2: pitchSourceData[sample] = z * zScale; break;
+                    case 3: poincareEstimator.pushSample(z); break;
+                    case 4: poincareEstimator.pushSample(x); break;
+                    case 5: poincareEstimator.pushSample(y); break;
+                    default: pitchSourceData[sample] = x * xScale; break;
+                }
+            }
 
-        pitchAnalysisBlock.setSample(0, sample, pitchSourceSample);
+            // --- Mixer control tick ---
+            // Level, pan and output level only advance here. While any of them ramps,
+            // the combined gains are interpolated linearly until the next tick.
+            if (--samplesUntilMixerTick <= 0)
+            {
+                samplesUntilMixerTick = controlInterval;
+                mixerRamping = smoothedLevelX.isSmoothing() || smoothedPanX.isSmoothing()
+                            || smoothedLevelY.isSmoothing() || smoothedPanY.isSmoothing()
+                            || smoothedLevelZ.isSmoothing() || smoothedPanZ.isSmoothing()
+                            || smoothedOutputLevel.isSmoothing();
 
-        // Scale and apply gain to each component
-        const float currentLevelX = smoothedLevelX.getNextValue();
-        const float currentLevelY = smoothedLevelY.getNextValue();
-        const float currentLevelZ = smoothedLevelZ.getNextValue();
+                if (mixerRamping)
+                {
+                    const MixerGains next = getNextMixerGains();
+                    const float k = 1.0f / controlInterval;
+                    mixerGainIncrement = { (next.xL - mixerGains.xL) * k, (next.xR - mixerGains.xR) * k,
+                                           (next.yL - mixerGains.yL) * k, (next.yR - mixerGains.yR) * k,
+                                           (next.zL - mixerGains.zL) * k, (next.zR - mixerGains.zR) * k };
+                }
+                else
+                {
+                    mixerGains = getCurrentMixerGains();
+                }
+            }
 
-        const float xSample = static_cast<float>(x) * xScale * currentLevelX;
-        const float ySample = static_cast<float>(y) * yScale * currentLevelY;
-        const float zSample = static_cast<float>(z) * zScale * currentLevelZ;
+            if (mixerRamping)
+            {
+                mixerGains.xL += mixerGainIncrement.xL; mixerGains.xR += mixerGainIncrement.xR;
+                mixerGains.yL += mixerGainIncrement.yL; mixerGains.yR += mixerGainIncrement.yR;
+                mixerGains.zL += mixerGainIncrement.zL; mixerGains.zR += mixerGainIncrement.zR;
+            }
 
-        // Apply panning (constant power)
-        const float currentPanX = smoothedPanX.getNextValue();
-        const float xL = xSample * juce::dsp::FastMathApproximations::cos((currentPanX + 1.0f) * juce::MathConstants<float>::pi * 0.25f);
-        const float xR = xSample * juce::dsp::FastMathApproximations::sin((currentPanX + 1.0f) * juce::MathConstants<float>::pi * 0.25f);
+            // Get the next sample from the ADSR envelope
+            const float adsrSample = polyphonic ? 1.0f : ampAdsr.getNextSample();
 
-        const float currentPanY = smoothedPanY.getNextValue();
-        const float yL = ySample * juce::dsp::FastMathApproximations::cos((currentPanY + 1.0f) * juce::MathConstants<float>::pi * 0.25f);
-        const float yR = ySample * juce::dsp::FastMathApproximations::sin((currentPanY + 1.0f) * juce::MathConstants<float>::pi * 0.25f);
+            // Mix all sources, with scale, level, pan and output level already folded into the gains
+            if (unison)
+            {
+                // The copies are spread across the stereo field before the mixer's own pan
+                const float xL = x * leadLeftGain + unisonLeft[0][sample], xR = x * leadRightGain + unisonRight[0][sample];
+                const float yL = y * leadLeftGain + unisonLeft[1][sample], yR = y * leadRightGain + unisonRight[1][sample];
+                const float zL = z * leadLeftGain + unisonLeft[2][sample], zR = z * leadRightGain + unisonRight[2][sample];
 
-        const float currentPanZ = smoothedPanZ.getNextValue();
-        const float zL = zSample * juce::dsp::FastMathApproximations::cos((currentPanZ + 1.0f) * juce::MathConstants<float>::pi * 0.25f);
-        const float zR = zSample * juce::dsp::FastMathApproximations::sin((currentPanZ + 1.0f) * juce::MathConstants<float>::pi * 0.25f);
+                leftChannel[sample]  = (xL * mixerGains.xL + yL * mixerGains.yL + zL * mixerGains.zL) * adsrSample;
+                rightChannel[sample] = (xR * mixerGains.xR + yR * mixerGains.yR + zR * mixerGains.zR) * adsrSample;
+            }
+            else
+            {
+                leftChannel[sample]  = (x * mixerGains.xL + y * mixerGains.yL + z * mixerGains.zL) * adsrSample;
+                rightChannel[sample] = (x * mixerGains.xR + y * mixerGains.yR + z * mixerGains.zR) * adsrSample;
+            }
+        }
 
-        // Get the next sample from the ADSR envelope
-        const float adsrSample = ampAdsr.getNextSample();
-        
-        const float currentOutputLevel = smoothedOutputLevel.getNextValue();
+        // --- Frequency Detection ---
+        // Hand the segment to the analyser, which analyses it on its worker
+        // thread, so the controller sees the freshest estimate at its next update.
+        if (! usePoincareSection && ! polyphonic)
+            pitchAnalyser.pushSamples(pitchSourceData + start, segmentLength);
 
-        // Mix all sources and apply master output level
-        leftChannel[sample]  = (xL + yL + zL) * currentOutputLevel * adsrSample;
-        rightChannel[sample] = (xR + yR + zR) * currentOutputLevel * adsrSample;
+        start = end;
     }
-    
-    // --- Frequency Detection & Control ---
-    // First, shift the existing data in the main analysis buffer to the left
-    const int numSamplesToCopy = buffer.getNumSamples();
-    analysisBuffer.copyFrom(0, 0, analysisBuffer, 0, numSamplesToCopy, analysisBuffer.getNumSamples() - numSamplesToCopy);
-    // Then, copy the new block of audio from our temporary buffer into the end of the main analysis buffer
-    analysisBuffer.copyFrom(0, analysisBuffer.getNumSamples() - numSamplesToCopy, pitchAnalysisBlock, 0, 0, numSamplesToCopy);
-
-    // Perform frequency detection on the block
-    float freq = pitchDetector.getPitch(analysisBuffer.getReadPointer(0));
-    if (freq > 0.0f) // YIN returns -1 if no frequency is detected
-        measuredFrequency = freq;
-    else
-        measuredFrequency = 0.0f; // Indicate no frequency found
+
+    // Events stamped past the end of the block, if any, still count
+    for (; midiEvent != midiMessages.cend(); ++midiEvent)
+        handleMidiMessage((*midiEvent).getMessage());
+
+    midiMessages.clear(); // We've processed the MIDI messages
+
+    // Publish the tracked frequency for the editor. The voices each have their
+    // own, so there is none to show in the polyphonic modes.
+    measuredFrequency = polyphonic ? 0.0f : frequencyTracker.getFrequency();
 
     highPassFilter(buffer, 15.0f);
 
@@ -738,6 +1269,38 @@ juce::AudioProcessorValueTreeState::ParameterLayout LorenzAudioProcessor::create
                                                            scientificNotationStringFromValue,
                                                            scientificNotationValueFromString));
     
+    // Numerical scheme used to advance the attractor. The adaptive scheme takes
+    // long steps on smooth parts of the orbit and interpolates the samples in between.
+    // It is cheaper than RK4 on non-stiff settings only: on stiff ones its steps
+    // are held at the stability limit and it costs more (see Benchmarks/).
+    // The Rosenbrock scheme is linearly implicit and stays stable on stiff settings
+    // (small masses, strong damping) with one or two steps per sample.
+    layout.add(std::make_unique<juce::AudioParameterChoice>("INTEGRATOR", "Integrator",
+                                                            juce::StringArray { "RK4", "Adaptive RK45", "Rosenbrock" },
+                                                            0)); // Default to RK4
+
+    // Where a note starts the attractor: from the initial state, with its
+    // start-up transient, or from a state already on the attractor, always
+    // the same one or one at a random phase of the orbit.
+    layout.add(std::make_unique<juce::AudioParameterChoice>("WARM_START", "Warm Start",
+                                                            juce::StringArray { "Off", "Fixed Phase", "Random Phase" },
+                                                            1)); // Default to the same state for every note
+
+    // --- Voices ---
+    // The polyphonic modes give each note its own attractor, envelope and pitch lock.
+    layout.add(std::make_unique<juce::AudioParameterChoice>("POLYPHONY", "Polyphony",
+                                                            juce::StringArray { "Mono", "8 Voices", "16 Voices" },
+                                                            0)); // Default to the monophonic synth
+
+    // Unison stacks detuned copies of the monophonic attractor across the stereo field
+    layout.add(std::make_unique<juce::AudioParameterChoice>("UNISON", "Unison",
+                                                            juce::StringArray { "Off", "2", "3", "4", "5", "6", "7", "8" },
+                                                            0)); // Default to a single attractor
+    layout.add(std::make_unique<juce::AudioParameterFloat>("UNISON_DETUNE", "Unison Detune",
+                                                           juce::NormalisableRange<float>(0.0f, 1.0f, 0.01f), 0.3f));
+    layout.add(std::make_unique<juce::AudioParameterFloat>("UNISON_WIDTH", "Unison Width",
+                                                           juce::NormalisableRange<float>(0.0f, 1.0f, 0.01f), 0.7f));
+
     // --- ADSR Parameters ---
     layout.add(std::make_unique<juce::AudioParameterFloat>("ATTACK", "Attack",
                                                            juce::NormalisableRange<float>(0.001f, 5.0f, 0.001f, 0.5f), 0.1f, "s"));
@@ -749,12 +1312,27 @@ juce::AudioProcessorValueTreeState::ParameterLayout LorenzAudioProcessor::create
                                                            juce::NormalisableRange<float>(0.001f, 5.0f, 0.001f, 0.5f), 0.5f, "s"));
 
     // --- Modulation Parameters ---
-    layout.add(std::make_unique<juce::AudioParameterChoice>("MOD_TARGET", "Mod Target",
-                                                            juce::StringArray{ "Off", "Sigma", "Rho", "Beta", "Mx", "My", "Mz", "Cx", "Cy", "Cy", "Taming" },
-                                                            0));
+    // Source, target and amount of each slot of the modulation matrix
+    ModulationRouter::addParameters(layout);
 
-    layout.add(std::make_unique<juce::AudioParameterFloat>("MOD_AMOUNT", "Mod Amount",
-                                                           juce::NormalisableRange<float>(-1.0f, 1.0f, 0.01f), 0.0f));
+    // Modulation sources: two LFOs and an envelope
+    const juce::StringArray lfoShapes { "Sine", "Square", "Triangle", "Saw Up", "Saw Down" };
+
+    layout.add(std::make_unique<juce::AudioParameterFloat>("LFO1_RATE", "LFO 1 Rate",
+                                                           juce::NormalisableRange<float>(0.01f, 20.0f, 0.01f, 0.3f), 1.0f, "Hz"));
+    layout.add(std::make_unique<juce::AudioParameterChoice>("LFO1_SHAPE", "LFO 1 Shape", lfoShapes, 0));
+    layout.add(std::make_unique<juce::AudioParameterFloat>("LFO2_RATE", "LFO 2 Rate",
+                                                           juce::NormalisableRange<float>(0.01f, 20.0f, 0.01f, 0.3f), 0.25f, "Hz"));
+    layout.add(std::make_unique<juce::AudioParameterChoice>("LFO2_SHAPE", "LFO 2 Shape", lfoShapes, 0));
+
+    layout.add(std::make_unique<juce::AudioParameterFloat>("MODENV_ATTACK", "Mod Env Attack",
+                                                           juce::NormalisableRange<float>(0.001f, 5.0f, 0.001f, 0.5f), 0.5f, "s"));
+    layout.add(std::make_unique<juce::AudioParameterFloat>("MODENV_DECAY", "Mod Env Decay",
+                                                           juce::NormalisableRange<float>(0.001f, 5.0f, 0.001f, 0.5f), 0.5f, "s"));
+    layout.add(std::make_unique<juce::AudioParameterFloat>("MODENV_SUSTAIN", "Mod Env Sustain",
+                                                           juce::NormalisableRange<float>(0.0f, 1.0f, 0.01f), 0.5f));
+    layout.add(std::make_unique<juce::AudioParameterFloat>("MODENV_RELEASE", "Mod Env Release",
+                                                           juce::NormalisableRange<float>(0.001f, 5.0f, 0.001f, 0.5f), 0.5f, "s"));
 
 
     // --- Frequency Control ---
@@ -785,8 +1363,25 @@ juce::AudioProcessorValueTreeState::ParameterLayout LorenzAudioProcessor::create
                                                            scientificNotationValueFromString));
 
     layout.add(std::make_unique<juce::AudioParameterChoice>("PITCH_SOURCE", "Pitch Source",
-                                                           juce::StringArray { "X", "Y", "Z" },
-                                                           0)); // Default to X
+                                                           juce::StringArray { "X", "Y", "Z",
+                                                                               "Section Z = Rho - 1", "Section X = 0", "Section Y = 0" },
+                                                           0)); // Default to X. The sections read the attractor state instead of the audio.
+
+    // Number of samples between two pitch analyses. Shorter hops track faster
+    // but cost proportionally more CPU.
+    layout.add(std::make_unique<juce::AudioParameterChoice>("PITCH_HOP", "Pitch Hop",
+                                                           juce::StringArray { "256", "512", "1024", "2048" },
+                                                           2)); // Default to 1024 samples
+
+    // Algorithm used on the analysis window. Stored with the preset, so each
+    // sound can use the cheapest detector that holds its pitch.
+    layout.add(std::make_unique<juce::AudioParameterChoice>("PITCH_DETECTOR", "Pitch Detector",
+                                                           juce::StringArray { "MPM", "YIN", "Zero Crossing" },
+                                                           0)); // Default to MPM
+
+    // Scales the PID gains by the learnt frequency/timestep sensitivity, so the
+    // same gains lock at the same speed across presets and registers.
+    layout.add(std::make_unique<juce::AudioParameterBool>("GAIN_SCHEDULING", "Gain Scheduling", true));
 
     // Temporary parameter for tuning
     layout.add(std::make_unique<juce::AudioParameterFloat>("PID_INTERVAL", "PID Interval",
@@ -10,6 +10,19 @@
 
 #include <JuceHeader.h>
 #include "LorenzOsc.h"
+#include "ParameterSnapshot.h"
+#include "ModulationRouter.h"
+#include "LFO.h"
+#include "ADSR.h"
+#include "PitchAnalyser.h"
+#include "PoincareEstimator.h"
+#include "TimestepPredictor.h"
+#include "WarmStartCache.h"
+#include "SensitivityEstimator.h"
+#include "FrequencyTracker.h"
+#include "ControlClock.h"
+#include "VoicePool.h"
+#include "UnisonStack.h"
 #include "PIDController.h"
 #include "FactoryPresets.h"
 
@@ -89,6 +102,12 @@ public:
 
     float getPitch() const;
 
+    /** The timestep the pitch controller runs the oscillator at, or 0 while it is not running. For display. */
+    float getControlledTimestep() const
+    {
+        return timestepControlled.load(std::memory_order_relaxed) ? displayedTimestep.load(std::memory_order_relaxed) : 0.0f;
+    }
+
     void parameterChanged (const juce::String& parameterID, float newValue) override;
 
 private:
@@ -122,6 +141,10 @@ private:
     int pointGenerationInterval = 0;
     static constexpr int pointsPerSecond = 11025;
 
+    // Every parameter the audio thread reads, loaded once per block from the pointers below.
+    ParameterSnapshot parameters;
+    void updateParameterSnapshot();
+
     // Cached parameter pointers
     std::atomic<float>* sigmaParam = nullptr;
     std::atomic<float>* rhoParam = nullptr;
@@ -147,8 +170,15 @@ private:
     std::atomic<float>* releaseParam = nullptr;
 
     // Modulation Parameters
-    std::atomic<float>* modTargetParam = nullptr;
-    std::atomic<float>* modAmountParam = nullptr;
+    std::array<std::atomic<float>*, numModulationSlots> modAmountParams {};
+    std::atomic<float>* lfo1RateParam = nullptr;
+    std::atomic<float>* lfo1ShapeParam = nullptr;
+    std::atomic<float>* lfo2RateParam = nullptr;
+    std::atomic<float>* lfo2ShapeParam = nullptr;
+    std::atomic<float>* modEnvAttackParam = nullptr;
+    std::atomic<float>* modEnvDecayParam = nullptr;
+    std::atomic<float>* modEnvSustainParam = nullptr;
+    std::atomic<float>* modEnvReleaseParam = nullptr;
 
     // Frequency control
     juce::RangedAudioParameter* targetFrequencyRangedParam = nullptr;
@@ -158,6 +188,13 @@ private:
     std::atomic<float>* kdParam = nullptr;
     std::atomic<float>* pitchSourceParam = nullptr;
     std::atomic<float>* pidIntervalParam = nullptr;
+    std::atomic<float>* pitchHopParam = nullptr;
+    std::atomic<float>* pitchDetectorParam = nullptr;
+    std::atomic<float>* gainSchedulingParam = nullptr;
+    std::atomic<float>* polyphonyParam = nullptr;
+    std::atomic<float>* unisonParam = nullptr;
+    std::atomic<float>* unisonDetuneParam = nullptr;
+    std::atomic<float>* unisonWidthParam = nullptr;
 
     std::atomic<float>* mxParam = nullptr;
     std::atomic<float>* myParam = nullptr;
@@ -166,6 +203,8 @@ private:
     std::atomic<float>* cyParam = nullptr;
     std::atomic<float>* czParam = nullptr;
     std::atomic<float>* tamingParam = nullptr;
+    std::atomic<float>* integratorParam = nullptr;
+    std::atomic<float>* warmStartParam = nullptr;
 
     // --- Monophonic Synth State ---
     juce::ADSR ampAdsr;
@@ -173,21 +212,107 @@ private:
     juce::Array<int> noteStack; // A simple stack to track the last notes played
     int currentNote = -1;
     float lastCC01Value = 0.0f; // To hold the latest CC01 value (0.0 - 1.0)
+    float lastVelocity = 0.0f;
+    float lastAftertouch = 0.0f;
+
+    /** Applies one MIDI message at the current position of the block. */
+    void handleMidiMessage(const juce::MidiMessage& msg);
+
+    /** Sets the target frequency, and the TARGET_FREQ parameter, to the current note. */
+    void setTargetNote(int noteNumber);
+
+    // The unison copies follow the oscillator above, which stays the one
+    // that is measured and locked. Monophonic mode only.
+    UnisonStack unisonStack;
+
+    // --- Polyphonic Synth State ---
+    // In the polyphonic modes the notes go to the voice pool instead of the
+    // oscillator above, and each voice holds its own pitch. The mixer, the
+    // modulation matrix and the output filter are shared.
+    VoicePool voicePool;
+    bool polyphonic = false;
+
+    /** Starts or releases a voice for a note message in the polyphonic modes. */
+    void handleVoiceNote(const juce::MidiMessage& msg);
+
+    // --- Modulation Matrix ---
+    // The modulators run at the control rate: they are advanced once per
+    // control tick, and the summed offsets are handed to the oscillator.
+    ModulationRouter modulationRouter { apvts };
+    LFO lfo1, lfo2;
+    ADSR modEnvelope;
+    AttractorOffsets modulationOffsets;
+    bool modulationActive = false;
+    ControlClock modulationClock;
+
+    /**
+     * Advances the modulators by one control tick and hands the offsets to the
+     * monophonic oscillators. Returns false when the matrix is idle and the
+     * offsets were left alone.
+     */
+    bool updateModulation();
 
     // --- Frequency Detection & Control ---
-    adamski::PitchMPM pitchDetector;
+    PitchAnalyser pitchAnalyser;
+    PoincareEstimator poincareEstimator;
+    bool usingPoincareSection = false;
     std::atomic<float> measuredFrequency { 0.0f };
 
+    // Smooths the estimates of either source and bridges their dropouts. It is
+    // advanced at every PID interval and fed each new estimate.
+    FrequencyTracker frequencyTracker;
+    uint32_t lastTrackedEstimateTime = 0;
+    float lastSectionFrequency = 0.0f;
+
+    /** Records the running timestep and feeds any new estimate to the tracker and the sensitivity estimator. */
+    void updateFrequencyTracking(float intervalSeconds);
+
     // --- PID Controller for Timestep ---
     PIDController pidController;
-    float dtTarget = 0.001f; // The value we are driving dt towards
+    // The timestep the controller drives the oscillator with. It is handed to
+    // the oscillator directly and never written to the TIMESTEP parameter,
+    // which stays the user's setting; the editor polls the copy for display.
+    float effectiveTimestep = 0.001f;
+    std::atomic<float> displayedTimestep { 0.001f };
+    std::atomic<bool> timestepControlled { false };
+
+    // Feed-forward: the timestep expected to give the target frequency
+    TimestepPredictor timestepPredictor;
+
+    /** Moves the controlled timestep to the predicted one for the current target, if known. */
+    void jumpToPredictedTimestep(bool snap);
 
-    double timeSinceLastPidUpdate = 0.0;
+    // States already on the attractor, for the notes to start from
+    WarmStartCache warmStartCache;
 
-    // Buffer for frequency analysis
-    juce::AudioBuffer<float> analysisBuffer;
+    /**
+     * Sets state to a cached state on the attractor, at the given phase index or
+     * at a random one, and returns true, if WARM_START is on and the cache is ready.
+     */
+    bool getWarmStartState(int phase, LorenzKernels::State<double>& state);
+
+    // Gain scheduling: the PID gains are divided by the learnt frequency/timestep
+    // sensitivity, relative to the one they were tuned at. The timesteps of the
+    // last PID intervals are kept to pair each estimate with the one it measured.
+    SensitivityEstimator sensitivityEstimator;
+    std::array<float, 32> timestepHistory {};
+    int timestepHistoryIndex = 0;
+
+    /** Timestep that was in use numUpdates controller updates ago. */
+    float getPastTimestep(int numUpdates) const;
+
+    ControlClock pidClock;
+
+    /** Runs one controller update and hands the new timestep to the oscillator. */
+    void updatePitchControl(float intervalSeconds);
+
+    // Per-block oscillator output (raw X, Y and Z state variables) and pitch-source signal
+    juce::AudioBuffer<float> oscBuffer;
 
     void highPassFilter(juce::AudioBuffer<float>& buffer, float cutoffFreq);
+
+    /** True, with the filter's state set to zero, once its tail is below the idle threshold. */
+    bool settleHighPassFilter();
     // State for the high-pass filter
     juce::Array<float> hpf_prevInput;
     juce::Array<float> hpf_prevOutput;
@@ -204,6 +329,24 @@ private:
     juce::SmoothedValue<float> smoothedLevelZ, smoothedPanZ;
     juce::SmoothedValue<float> smoothedOutputLevel;
 
+    // Combined scale, level, pan and output gains applied to the three state variables.
+    // The mixer smoothers advance once per control tick and these gains are
+    // interpolated linearly in between.
+    struct MixerGains
+    {
+        float xL, xR, yL, yR, zL, zR;
+    };
+
+    MixerGains mixerGains {};
+    MixerGains mixerGainIncrement {};
+    bool mixerRamping = false;
+    int samplesUntilMixerTick = 0;
+
+    MixerGains getNextMixerGains();
+    MixerGains getCurrentMixerGains() const;
+    static MixerGains computeMixerGains(float levelX, float panX, float levelY, float panY,
+                                        float levelZ, float panZ, float outputLevel);
+
     void resetSmoothedValues();
     void resetAudioEngineState();
 
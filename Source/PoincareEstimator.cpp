@@ -0,0 +1,61 @@
+/*
+  ==============================================================================
+
+    PoincareEstimator.cpp
+    Created: 16 Oct 2026 10:00:00am
+    Author:  Olivier Doaré
+
+  ==============================================================================
+*/
+
+#include "PoincareEstimator.h"
+
+void PoincareEstimator::prepare(double newSampleRate)
+{
+    sampleRate = newSampleRate;
+    maxPeriod = sampleRate / minFrequency;
+    reset();
+}
+
+void PoincareEstimator::reset()
+{
+    previous = level;
+    armed = false;
+    clearIntervals();
+}
+
+void PoincareEstimator::registerCrossing(float fraction) noexcept
+{
+    // The crossing happened (1 - fraction) samples ago
+    const double crossingAge = 1.0 - fraction;
+    const double interval = timeSinceCrossing - crossingAge;
+
+    timeSinceCrossing = crossingAge;
+    armed = false;
+
+    if (! hasCrossed)
+    {
+        hasCrossed = true;
+        return;
+    }
+
+    // Running mean of the last numIntervals intervals
+    intervalSum += interval - intervals[(size_t) intervalIndex];
+    intervals[(size_t) intervalIndex] = interval;
+    intervalIndex = (intervalIndex + 1) % numIntervals;
+    intervalCount = juce::jmin(intervalCount + 1, numIntervals);
+
+    // Before the buffer is full, the missing entries are still zero
+    frequency = intervalSum > 0.0 ? static_cast<float>(sampleRate * intervalCount / intervalSum) : 0.0f;
+}
+
+void PoincareEstimator::clearIntervals() noexcept
+{
+    intervals.fill(0.0);
+    intervalIndex = 0;
+    intervalCount = 0;
+    intervalSum = 0.0;
+    hasCrossed = false;
+    timeSinceCrossing = 0.0;
+    frequency = 0.0f;
+}
@@ -0,0 +1,91 @@
+/*
+  ==============================================================================
+
+    PoincareEstimator.h
+    Created: 16 Oct 2026 10:00:00am
+    Author:  Olivier Doaré
+
+  ==============================================================================
+*/
+
+#pragma once
+
+#include <JuceHeader.h>
+
+/**
+ * Estimates the period of the attractor from the crossings of a Poincaré
+ * section, directly from one of its state variables.
+ *
+ * A crossing is counted each time the coordinate goes up through the section
+ * level (e.g. z = rho - 1, or x = 0 with vx > 0). Its time is interpolated
+ * linearly between two samples, and the frequency is the inverse of the mean
+ * of the last few crossing intervals. This is O(1) per sample and lags the
+ * attractor by about one period, instead of a whole analysis window.
+ */
+class PoincareEstimator
+{
+public:
+    PoincareEstimator() = default;
+
+    void prepare(double sampleRate);
+
+    /** Clears the crossing history and the measured frequency. */
+    void reset();
+
+    /** Sets the section level. The coordinate must fall below level - hysteresis before the next crossing counts. */
+    void setSection(float newLevel, float newHysteresis)
+    {
+        level = newLevel;
+        hysteresis = newHysteresis;
+    }
+
+    /** Feeds the next value of the section coordinate. */
+    void pushSample(float value) noexcept
+    {
+        timeSinceCrossing += 1.0;
+
+        if (! armed && value < level - hysteresis)
+            armed = true;
+
+        if (armed && previous < level && value >= level)
+            registerCrossing((level - previous) / (value - previous));
+
+        // No crossing for longer than the lowest measurable period: no pitch
+        if (timeSinceCrossing > maxPeriod)
+            clearIntervals();
+
+        previous = value;
+    }
+
+    /** The measured frequency in Hz, or 0 if there is no regular crossing. */
+    float getFrequency() const { return frequency; }
+
+    /** Age in samples of the middle of the intervals behind the measured frequency. */
+    double getLatencySamples() const { return timeSinceCrossing + 0.5 * intervalSum; }
+
+private:
+    // fraction: where the crossing lies between the previous sample (0) and the current one (1)
+    void registerCrossing(float fraction) noexcept;
+    void clearIntervals() noexcept;
+
+    static constexpr int numIntervals = 4;
+    static constexpr double minFrequency = 20.0;
+
+    double sampleRate = 44100.0;
+    double maxPeriod = 44100.0 / minFrequency;
+
+    float level = 0.0f;
+    float hysteresis = 0.0f;
+
+    float previous = 0.0f;
+    bool armed = false;
+    bool hasCrossed = false;
+    double timeSinceCrossing = 0.0;
+
+    std::array<double, numIntervals> intervals {};
+    int intervalIndex = 0;
+    int intervalCount = 0;
+    double intervalSum = 0.0;
+
+    float frequency = 0.0f;
+};
@@ -0,0 +1,208 @@
+/*
+  ==============================================================================
+
+    RenderWorkerPool.cpp
+    Created: 16 Oct 2026 10:00:00am
+    Author:  Olivier Doaré
+
+  ==============================================================================
+*/
+
+#include "RenderWorkerPool.h"
+
+RenderWorkerPool::~RenderWorkerPool()
+{
+    release();
+}
+
+void RenderWorkerPool::prepare(int numWorkers, double sampleRate, int blockSize)
+{
+    release();
+
+    dispatchIntervalTicks = juce::Time::secondsToHighResolutionTicks(blockSize / sampleRate);
+    wakeMarginTicks = juce::Time::secondsToHighResolutionTicks(0.001);
+    idleTicks = juce::Time::secondsToHighResolutionTicks(1.0);
+    lastBatchTicks = juce::Time::getHighResolutionTicks();
+
+    // The audio thread may wait for a step a worker is running, so the workers
+    // get the same treatment from the scheduler as the audio thread.
+    const auto realtimeOptions = juce::Thread::RealtimeOptions{}.withApproximateAudioProcessingTime(blockSize, sampleRate);
+
+    for (int i = 0; i < numWorkers; ++i)
+    {
+        workers.push_back(std::make_unique<Worker>(*this));
+
+        if (! workers.back()->startRealtimeThread(realtimeOptions))
+            workers.back()->startThread(juce::Thread::Priority::highest);
+    }
+}
+
+void RenderWorkerPool::release()
+{
+    for (auto& worker : workers)
+        worker->signalThreadShouldExit();
+
+    for (auto& worker : workers)
+        worker->stopThread(1000);
+
+    workers.clear();
+}
+
+void RenderWorkerPool::run(JobList& jobs, int numJobs, double deadlineSeconds)
+{
+    jassert(numJobs <= maxJobs);
+
+    if (numJobs <= 0)
+        return;
+
+    if (workers.empty() || numJobs == 1)
+    {
+        for (int i = 0; i < numJobs; ++i)
+            for (int step = 0; step < jobs.getNumSteps(i); ++step)
+                jobs.runJobStep(i, step);
+
+        return;
+    }
+
+    // The previous batch is complete, so no worker is reading any of these.
+    const int64_t now = juce::Time::getHighResolutionTicks();
+
+    // Follow the host's rhythm, but not the pauses between two notes
+    if (const int64_t interval = now - lastBatchTicks.load(std::memory_order_relaxed); interval < idleTicks)
+    {
+        const int64_t smoothed = dispatchIntervalTicks.load(std::memory_order_relaxed);
+        dispatchIntervalTicks.store(smoothed + (interval - smoothed) / 8, std::memory_order_relaxed);
+    }
+
+    jobList = &jobs;
+    jobsDone.store(0, std::memory_order_relaxed);
+    deadlineTicks.store(now + juce::Time::secondsToHighResolutionTicks(deadlineSeconds), std::memory_order_relaxed);
+    lastBatchTicks.store(now, std::memory_order_relaxed);
+    ++batch;
+
+    for (int i = 0; i < numJobs; ++i)
+        jobProgress[(size_t) i].store(packProgress(batch, 0), std::memory_order_relaxed);
+
+    state.store(packState(batch, numJobs, 0), std::memory_order_release);
+
+    // The audio thread works through the batch like any worker...
+    runAvailableJobs(false);
+
+    // ...waits for the jobs the workers are still running until the deadline,
+    // then finishes them itself from the end of their current step.
+    while (jobsDone.load(std::memory_order_acquire) < numJobs)
+    {
+        if (isPastDeadline())
+            takeOverJobsInProgress(numJobs);
+        else
+            std::this_thread::yield();
+    }
+}
+
+int RenderWorkerPool::runAvailableJobs(bool isWorker)
+{
+    int numRun = 0;
+    uint64_t current = state.load(std::memory_order_acquire);
+
+    for (;;)
+    {
+        const int numJobs = static_cast<int>((current >> 16) & 0xffff);
+        const int next = static_cast<int>(current & 0xffff);
+
+        if (next >= numJobs)
+            break;
+
+        // Past the deadline the rest of the batch is left to the audio thread
+        if (isWorker && isPastDeadline())
+            break;
+
+        // On failure current is reloaded, possibly with a later batch
+        if (! state.compare_exchange_weak(current, current + 1, std::memory_order_acq_rel, std::memory_order_acquire))
+            continue;
+
+        if (runClaimedJob(static_cast<uint32_t>(current >> 32), next, isWorker))
+            ++numRun;
+
+        current = state.load(std::memory_order_acquire);
+    }
+
+    return numRun;
+}
+
+bool RenderWorkerPool::runClaimedJob(uint32_t jobBatch, int index, bool isWorker)
+{
+    auto& progress = jobProgress[(size_t) index];
+    int numSteps = 1; // Read once the first step is ours: until then the batch may be over
+
+    for (int step = 0; step < numSteps; ++step)
+    {
+        // A worker hands the rest of the job over at the deadline, between two steps
+        if (isWorker && isPastDeadline())
+            return false;
+
+        // Fails if the audio thread took the job over. The batch number keeps a
+        // worker late from an earlier batch off the same job of a later one.
+        const auto free = static_cast<uint32_t>(2 * step);
+        uint64_t expected = packProgress(jobBatch, free);
+        if (! progress.compare_exchange_strong(expected, packProgress(jobBatch, free + 1), std::memory_order_acq_rel))
+            return false;
+
+        if (step == 0)
+            numSteps = jobList->getNumSteps(index);
+
+        jobList->runJobStep(index, step);
+        progress.store(packProgress(jobBatch, free + 2), std::memory_order_release);
+    }
+
+    jobsDone.fetch_add(1, std::memory_order_release);
+    return true;
+}
+
+void RenderWorkerPool::takeOverJobsInProgress(int numJobs)
+{
+    for (int i = 0; i < numJobs; ++i)
+    {
+        auto& progress = jobProgress[(size_t) i];
+        uint64_t current = progress.load(std::memory_order_acquire);
+        const auto value = static_cast<uint32_t>(current);
+        const int numSteps = jobList->getNumSteps(i);
+
+        // Already ours, finished, or in the middle of a step: the next call looks again
+        if ((value & takenOverFlag) != 0 || value >= static_cast<uint32_t>(2 * numSteps) || (value & 1) != 0)
+            continue;
+
+        if (! progress.compare_exchange_strong(current, packProgress(batch, value | takenOverFlag), std::memory_order_acq_rel))
+            continue;
+
+        for (int step = static_cast<int>(value / 2); step < numSteps; ++step)
+            jobList->runJobStep(i, step);
+
+        jobsDone.fetch_add(1, std::memory_order_relaxed);
+    }
+}
+
+void RenderWorkerPool::Worker::run()
+{
+    juce::ScopedNoDenormals noDenormals;
+
+    while (! threadShouldExit())
+    {
+        if (pool.runAvailableJobs(true) > 0)
+            continue;
+
+        // Sleep until just before the next batch is due and spin until it comes,
+        // then poll, slowly once the pool is idle.
+        const int64_t sinceLastBatch = juce::Time::getHighResolutionTicks() - pool.lastBatchTicks.load(std::memory_order_relaxed);
+        const int64_t interval = pool.dispatchIntervalTicks.load(std::memory_order_relaxed);
+        const int64_t untilWake = interval - pool.wakeMarginTicks - sinceLastBatch;
+
+        if (untilWake >= pool.wakeMarginTicks)
+            wait(juce::jmax(1, static_cast<int>(juce::Time::highResolutionTicksToSeconds(untilWake) * 1000.0)));
+        else if (sinceLastBatch < interval + interval / 4)
+            std::this_thread::yield();
+        else if (sinceLastBatch < pool.idleTicks)
+            wait(1);
+        else
+            wait(50);
+    }
+}
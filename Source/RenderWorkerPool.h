@@ -0,0 +1,136 @@
+/*
+  ==============================================================================
+
+    RenderWorkerPool.h
+    Created: 16 Oct 2026 10:00:00am
+    Author:  Olivier Doaré
+
+  ==============================================================================
+*/
+
+#pragma once
+
+#include <JuceHeader.h>
+
+/**
+ * A fixed set of threads that help the audio thread through the independent
+ * jobs of a block, such as rendering the voice banks.
+ *
+ * The threads are started by prepare() and never created, woken or locked by
+ * the audio thread. A batch is published through a single atomic word holding
+ * the batch number, the number of jobs and the next unclaimed job; every
+ * thread, the audio thread included, takes the next job with a compare and
+ * swap until none is left. A slow thread therefore never holds up the others:
+ * whatever it has not claimed is taken by whoever is free.
+ *
+ * The pool measures the interval between two batches. Between batches a
+ * worker sleeps until about a millisecond before the next one is due, then
+ * spins until it arrives, or for a quarter of the interval past that. Then it
+ * polls every millisecond, and every 50 ms once the pool has been idle for a
+ * second. With dispatch intervals of a millisecond or less there is no time to
+ * sleep, and the workers spin through the gaps.
+ *
+ * A job runs as a sequence of short steps, and whoever runs it claims each
+ * step in turn. Workers do not claim jobs or steps past the batch deadline: a
+ * worker that wakes up late leaves the rest to the audio thread, which renders
+ * anything left on its own. Past the deadline the audio thread also takes
+ * over any job still in progress at the end of its current step, so it waits
+ * for at most one step of each job, not for a whole job. The workers run at
+ * real-time priority, so that step is rarely preempted.
+ */
+class RenderWorkerPool
+{
+public:
+    /**
+     * The jobs of one batch. The jobs run on any thread, in any order, but the
+     * steps of a job run in order, one at a time, possibly on different threads.
+     */
+    struct JobList
+    {
+        virtual ~JobList() = default;
+        virtual int getNumSteps(int index) const = 0; // At least one
+        virtual void runJobStep(int index, int step) = 0;
+    };
+
+    static constexpr int maxJobs = 64;
+
+    RenderWorkerPool() = default;
+    ~RenderWorkerPool();
+
+    /**
+     * Starts numWorkers threads. The batches are expected about once per
+     * blockSize samples at the given sample rate until the real interval is
+     * measured. With no workers every job runs on the audio thread. Not real-time safe.
+     */
+    void prepare(int numWorkers, double sampleRate, int blockSize);
+
+    /** Stops the workers. */
+    void release();
+
+    int getNumWorkers() const { return static_cast<int>(workers.size()); }
+
+    /**
+     * Runs jobs 0 to numJobs - 1 of the list and returns when they are all
+     * done. Workers may take jobs and steps for deadlineSeconds from now; the
+     * calling thread takes any job still unclaimed, and after the deadline the
+     * remaining steps of any job in progress. Audio thread.
+     */
+    void run(JobList& jobs, int numJobs, double deadlineSeconds);
+
+private:
+    class Worker : public juce::Thread
+    {
+    public:
+        explicit Worker(RenderWorkerPool& owner) : juce::Thread("Render Worker"), pool(owner) {}
+        void run() override;
+
+    private:
+        RenderWorkerPool& pool;
+    };
+
+    /** Claims and runs jobs of the current batch until none is left. Returns the number run. */
+    int runAvailableJobs(bool isWorker);
+
+    /**
+     * Runs the steps of a claimed job of the given batch, claiming each one.
+     * Returns false if a worker stopped at the deadline or the job was taken over.
+     */
+    bool runClaimedJob(uint32_t jobBatch, int index, bool isWorker);
+
+    /** Takes over the jobs that are between two steps, and runs their remaining steps. Audio thread. */
+    void takeOverJobsInProgress(int numJobs);
+
+    bool isPastDeadline() const { return juce::Time::getHighResolutionTicks() > deadlineTicks.load(std::memory_order_relaxed); }
+
+    // Batch number (high 32 bits), number of jobs (16 bits) and next job (low 16 bits)
+    static uint64_t packState(uint32_t batch, int numJobs, int nextJob)
+    {
+        return (static_cast<uint64_t>(batch) << 32) | (static_cast<uint64_t>(numJobs) << 16) | static_cast<uint64_t>(nextJob);
+    }
+
+    // Progress of a job: batch number (high 32 bits) and twice the next step,
+    // plus one while that step runs. A job taken over by the audio thread is
+    // flagged, so that no worker claims its steps any more.
+    static constexpr uint32_t takenOverFlag = 0x80000000u;
+
+    static uint64_t packProgress(uint32_t batch, uint32_t progress)
+    {
+        return (static_cast<uint64_t>(batch) << 32) | static_cast<uint64_t>(progress);
+    }
+
+    std::atomic<uint64_t> state { 0 };
+    std::array<std::atomic<uint64_t>, maxJobs> jobProgress {};
+    std::atomic<int> jobsDone { 0 };
+    std::atomic<int64_t> deadlineTicks { 0 };
+    std::atomic<int64_t> lastBatchTicks { 0 };
+    std::atomic<int64_t> dispatchIntervalTicks { 0 }; // Smoothed interval between two batches
+    JobList* jobList = nullptr; // Published by the release store of state
+    uint32_t batch = 0;
+
+    int64_t wakeMarginTicks = 0;
+    int64_t idleTicks = 0;
+
+    std::vector<std::unique_ptr<Worker>> workers;
+
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR (RenderWorkerPool)
+};
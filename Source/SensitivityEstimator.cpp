@@ -0,0 +1,85 @@
+/*
+  ==============================================================================
+
+    SensitivityEstimator.cpp
+    Created: 16 Oct 2026 10:00:00am
+    Author:  Olivier Doaré
+
+  ==============================================================================
+*/
+
+#include "SensitivityEstimator.h"
+
+void SensitivityEstimator::reset()
+{
+    a = b = 0.0;
+    p11 = p22 = initialCovariance;
+    p12 = 0.0;
+    numObservations = 0;
+    lastTimestep = lastFrequency = 0.0f;
+}
+
+void SensitivityEstimator::addObservation(float timestep, float frequency)
+{
+    if (timestep <= 0.0f || frequency <= 0.0f)
+        return;
+
+    const double u = timestep / timestepScale;
+
+    // Start from the proportional model, so the fit begins near the right answer
+    if (numObservations == 0)
+    {
+        a = frequency / u;
+        b = 0.0;
+    }
+
+    // Gain vector k = P phi / (lambda + phi' P phi), with phi = (u, 1)
+    const double pu1 = p11 * u + p12;
+    const double pu2 = p12 * u + p22;
+    const double denominator = forgetting + u * pu1 + pu2;
+    const double k1 = pu1 / denominator;
+    const double k2 = pu2 / denominator;
+
+    const double error = frequency - (a * u + b);
+    a += k1 * error;
+    b += k2 * error;
+
+    // P = (P - k phi' P) / lambda
+    p11 = (p11 - k1 * pu1) / forgetting;
+    p12 = (p12 - k1 * pu2) / forgetting;
+    p22 = (p22 - k2 * pu2) / forgetting;
+
+    // Without excitation (a steady locked note) forgetting inflates P without
+    // bound; cap it so the next step change is not over-weighted.
+    if (const double trace = p11 + p22; trace > maxCovarianceTrace)
+    {
+        const double scale = maxCovarianceTrace / trace;
+        p11 *= scale;
+        p12 *= scale;
+        p22 *= scale;
+    }
+
+    ++numObservations;
+    lastTimestep = timestep;
+    lastFrequency = frequency;
+}
+
+float SensitivityEstimator::getSensitivity() const
+{
+    if (numObservations == 0)
+        return 0.0f;
+
+    const double proportional = lastFrequency / lastTimestep;
+    const double slope = a / timestepScale;
+
+    if (numObservations < minObservations || slope < 0.5 * proportional || slope > 2.0 * proportional)
+        return static_cast<float>(proportional);
+
+    return static_cast<float>(slope);
+}
+
+float SensitivityEstimator::getGainScale() const
+{
+    const float sensitivity = getSensitivity();
+    return sensitivity > 0.0f ? juce::jlimit(minGainScale, maxGainScale, referenceSensitivity / sensitivity) : 1.0f;
+}
@@ -0,0 +1,66 @@
+/*
+  ==============================================================================
+
+    SensitivityEstimator.h
+    Created: 16 Oct 2026 10:00:00am
+    Author:  Olivier Doaré
+
+  ==============================================================================
+*/
+
+#pragma once
+
+#include <JuceHeader.h>
+
+/**
+ * Learns how much the measured frequency changes per unit of timestep,
+ * d(frequency)/d(dt), from the (timestep, frequency) pairs seen by the pitch
+ * controller.
+ *
+ * Fits frequency = a * dt + b by recursive least squares with exponential
+ * forgetting, once per controller update, in constant memory. The slope a is
+ * the sensitivity. Until the fit has seen enough excitation, or if it wanders
+ * far from the proportional model frequency = dt * f / dt, the ratio of the
+ * last pair is used instead.
+ */
+class SensitivityEstimator
+{
+public:
+    SensitivityEstimator() { reset(); }
+
+    /** Forgets everything learnt. */
+    void reset();
+
+    /** Adds one observation: the frequency measured while the oscillator ran at timestep. */
+    void addObservation(float timestep, float frequency);
+
+    /** Estimated d(frequency)/d(dt) in Hz per unit timestep, or 0 before the first observation. */
+    float getSensitivity() const;
+
+    /**
+     * Factor for PID gains tuned at referenceSensitivity, so the loop gain
+     * stays the same whatever the sensitivity. 1 before the first observation.
+     */
+    float getGainScale() const;
+
+    // Sensitivity at which the default PID gains were tuned (the AllStates and
+    // LowMach presets are close to it), and the bounds of the gain scale.
+    static constexpr float referenceSensitivity = 30000.0f;
+    static constexpr float minGainScale = 0.1f;
+    static constexpr float maxGainScale = 10.0f;
+
+private:
+    // The timestep is scaled to order 1 so both parameters have comparable magnitudes
+    static constexpr double timestepScale = 0.01;
+    static constexpr double forgetting = 0.98;
+    static constexpr double initialCovariance = 1.0e2;
+    static constexpr double maxCovarianceTrace = 1.0e4;
+    static constexpr int minObservations = 8;
+
+    // Parameters of frequency = a * u + b, with u = dt / timestepScale
+    double a = 0.0, b = 0.0;
+    double p11 = 0.0, p12 = 0.0, p22 = 0.0; // Symmetric covariance
+
+    int numObservations = 0;
+    float lastTimestep = 0.0f, lastFrequency = 0.0f;
+};
@@ -0,0 +1,232 @@
+/*
+  ==============================================================================
+
+    TimestepPredictor.cpp
+    Created: 16 Oct 2026 10:00:00am
+    Author:  Olivier Doaré
+
+  ==============================================================================
+*/
+
+#include "TimestepPredictor.h"
+#include "FrequencyTracker.h"
+
+namespace
+{
+    // Length of each simulation, in simulation time (the attractor's own time
+    // units): a settling part that is discarded, then the measured part. The
+    // period of the attractor is constant in simulation time, so this covers
+    // the same number of periods whatever the timestep.
+    constexpr double settleTime = 20.0;
+    constexpr double measureTime = 30.0;
+
+    // Upper bound on the measured part, in seconds of audio, for the smallest timesteps
+    constexpr double maxMeasureSeconds = 4.0;
+
+    constexpr int renderChunk = 512;
+
+    // Analysis windows spread over the measured part, at most, with at least
+    // this many windows' worth of signal to spread them over.
+    constexpr int maxAnalysisWindows = 16;
+    constexpr int minAnalysisWindows = 4;
+
+    // Hysteresis of the Poincaré sections, in attractor units, as in the processor
+    constexpr float sectionHysteresis = 0.5f;
+}
+
+TimestepPredictor::TimestepPredictor()
+    : AttractorTableWorker("Timestep Predictor")
+{
+    for (size_t i = 0; i < detectors.size(); ++i)
+        detectors[i] = PitchDetector::create(static_cast<PitchDetector::Type>(i));
+}
+
+TimestepPredictor::~TimestepPredictor()
+{
+    release();
+}
+
+void TimestepPredictor::prepare(double newSampleRate, int newAnalysisWindowSize, float newMinTimestep, float newMaxTimestep)
+{
+    release();
+
+    sampleRate = newSampleRate;
+    analysisWindowSize = newAnalysisWindowSize;
+    minTimestep = newMinTimestep;
+    maxTimestep = newMaxTimestep;
+
+    simulator.prepareToPlay(sampleRate);
+    sectionEstimator.prepare(sampleRate);
+    for (auto& detector : detectors)
+        detector->prepare(sampleRate, analysisWindowSize);
+
+    measureBuffer.assign((size_t) juce::jmax(maxMeasureSeconds * sampleRate, (double) minAnalysisWindows * analysisWindowSize), 0.0f);
+    windowEstimates.reserve((size_t) maxAnalysisWindows);
+    for (auto& buffer : renderBuffers)
+        buffer.assign((size_t) renderChunk, 0.0f);
+
+    // Tables built for another sample rate are stale
+    startWorker();
+}
+
+void TimestepPredictor::release()
+{
+    stopWorker();
+}
+
+void TimestepPredictor::setAttractor(const ParameterSnapshot& parameters)
+{
+    requestTable(parameters);
+}
+
+float TimestepPredictor::predictTimestep(float frequency) const
+{
+    const TimestepTable& table = getTable();
+
+    if (frequency <= 0.0f || ! isTableCurrent())
+        return 0.0f;
+
+    // Interpolate between two consecutive measured points around the
+    // frequency, in the log domain, where the frequency is close to
+    // proportional to the timestep. Outside the measured range, extrapolate
+    // proportionally from the closest point.
+    int previous = -1, closest = -1;
+    float closestDistance = std::numeric_limits<float>::max();
+    float timestep = 0.0f;
+
+    for (int i = 0; i < numPoints; ++i)
+    {
+        const float f = table.frequencies[(size_t) i];
+        if (f <= 0.0f)
+            continue;
+
+        const float distance = std::abs(std::log(f / frequency));
+        if (distance < closestDistance)
+        {
+            closestDistance = distance;
+            closest = i;
+        }
+
+        if (previous >= 0)
+        {
+            const float f0 = table.frequencies[(size_t) previous];
+
+            if ((f0 <= frequency && frequency <= f) || (f <= frequency && frequency <= f0))
+            {
+                const float t0 = table.timesteps[(size_t) previous];
+                const float t1 = table.timesteps[(size_t) i];
+                const float position = f != f0 ? std::log(frequency / f0) / std::log(f / f0) : 0.0f;
+                timestep = t0 * std::pow(t1 / t0, position);
+                break;
+            }
+        }
+
+        previous = i;
+    }
+
+    if (timestep <= 0.0f)
+    {
+        if (closest < 0)
+            return 0.0f;
+
+        timestep = table.timesteps[(size_t) closest] * frequency / table.frequencies[(size_t) closest];
+    }
+
+    return juce::jlimit(minTimestep, maxTimestep, timestep);
+}
+
+bool TimestepPredictor::buildTable(TimestepTable& table, const ParameterSnapshot& parameters, uint32_t generation)
+{
+    for (int i = 0; i < numPoints; ++i)
+    {
+        // Give up as soon as the request is superseded
+        if (isSuperseded(generation))
+            return false;
+
+        const float timestep = minTimestep * std::pow(maxTimestep / minTimestep, (float) i / (numPoints - 1));
+        table.timesteps[(size_t) i] = timestep;
+        table.frequencies[(size_t) i] = measureFrequency(parameters, timestep);
+    }
+
+    return true;
+}
+
+float TimestepPredictor::measureFrequency(const ParameterSnapshot& parameters, float timestep)
+{
+    ParameterSnapshot simulated = parameters;
+    simulated.timestep = timestep;
+    simulator.setParameters(simulated);
+    simulator.reset(); // Also snaps the parameters to their targets
+
+    // Coordinate of the pitch source: X, Y, Z, then the sections on Z, X and Y.
+    // The voices read a signal source as the section on the same coordinate.
+    static constexpr int coordinates[] = { 0, 1, 2, 2, 0, 1 };
+    const int source = juce::jlimit(0, 5, parameters.pitchSource);
+    const int coordinate = coordinates[source];
+    const bool useSection = source >= 3 || parameters.polyphony != 0;
+
+    // A detector needs a few whole windows, whatever the number of periods
+    const int minMeasureSamples = useSection ? 0 : minAnalysisWindows * analysisWindowSize;
+    const int settleSamples = juce::jmin((int) measureBuffer.size(), static_cast<int>(settleTime / timestep));
+    const int measureSamples = juce::jmin((int) measureBuffer.size(), juce::jmax(minMeasureSamples, static_cast<int>(measureTime / timestep)));
+
+    for (int rendered = 0; rendered < settleSamples + measureSamples;)
+    {
+        const int n = juce::jmin(renderChunk, settleSamples + measureSamples - rendered);
+        simulator.renderBlock(renderBuffers[0].data(), renderBuffers[1].data(), renderBuffers[2].data(), n);
+
+        for (int i = 0; i < n; ++i)
+        {
+            const float value = renderBuffers[(size_t) coordinate][(size_t) i];
+            if (! std::isfinite(value))
+                return 0.0f; // Unstable at this timestep
+
+            if (rendered + i >= settleSamples)
+                measureBuffer[(size_t) (rendered + i - settleSamples)] = value;
+        }
+
+        rendered += n;
+    }
+
+    if (useSection)
+    {
+        sectionEstimator.setSection(coordinate == 2 ? parameters.rho - 1.0f : 0.0f, sectionHysteresis);
+        sectionEstimator.reset();
+
+        for (int i = 0; i < measureSamples; ++i)
+            sectionEstimator.pushSample(measureBuffer[(size_t) i]);
+
+        return sectionEstimator.getFrequency();
+    }
+
+    // The median of the estimates the lock would trust, over windows spread
+    // across the measured part, so one odd window does not set the table.
+    auto& detector = *detectors[(size_t) juce::jlimit(0, (int) detectors.size() - 1, parameters.pitchDetector)];
+    const int span = measureSamples - analysisWindowSize;
+    const int numWindows = juce::jmin(maxAnalysisWindows, span / (analysisWindowSize / 2) + 1);
+
+    windowEstimates.clear();
+
+    for (int w = 0; w < numWindows; ++w)
+    {
+        const int start = numWindows > 1 ? span * w / (numWindows - 1) : 0;
+        const float frequency = detector.detect(measureBuffer.data() + start);
+
+        if (frequency > 0.0f && detector.getConfidence() >= FrequencyTracker::minConfidence)
+            windowEstimates.push_back(frequency);
+    }
+
+    if (windowEstimates.empty())
+        return 0.0f;
+
+    const auto middle = windowEstimates.begin() + (std::ptrdiff_t) (windowEstimates.size() / 2);
+    std::nth_element(windowEstimates.begin(), middle, windowEstimates.end());
+    return *middle;
+}
+
+bool TimestepPredictor::isSameAttractor(const ParameterSnapshot& a, const ParameterSnapshot& b) const
+{
+    // The table also depends on how the pitch is measured
+    return AttractorTableWorker::isSameAttractor(a, b) && a.pitchSource == b.pitchSource
+        && a.pitchDetector == b.pitchDetector && (a.polyphony != 0) == (b.polyphony != 0);
+}
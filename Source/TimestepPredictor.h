@@ -0,0 +1,95 @@
+/*
+  ==============================================================================
+
+    TimestepPredictor.h
+    Created: 16 Oct 2026 10:00:00am
+    Author:  Olivier Doaré
+
+  ==============================================================================
+*/
+
+#pragma once
+
+#include <JuceHeader.h>
+#include "LorenzOsc.h"
+#include "PitchDetector.h"
+#include "PoincareEstimator.h"
+#include "AttractorTableWorker.h"
+
+/**
+ * Predicts the timestep that makes the attractor sound at a given frequency,
+ * so a note can start at the right pitch and the PID only trims the residual.
+ *
+ * For the current attractor parameters, a background thread runs short offline
+ * simulations at a set of timesteps spread logarithmically over the TIMESTEP
+ * range, and measures the frequency of the pitch source for each. The result is
+ * a timestep -> frequency table, inverted by interpolation on the audio thread.
+ *
+ * The frequency is measured the way the pitch lock will measure it, so a note
+ * starts where the lock expects it rather than, say, an octave away: with the
+ * selected PitchDetector over analysis windows of the processor's size for a
+ * signal source, or with a Poincaré section for a section source and for the
+ * voices of the polyphonic mode, which always read a section.
+ *
+ * The table is rebuilt by an AttractorTableWorker when any parameter that
+ * changes the attractor's period in simulation time (sigma, rho, beta, masses,
+ * damping, taming, integrator) or the way the pitch is measured (source,
+ * detector, polyphony) changes.
+ */
+struct TimestepTable
+{
+    static constexpr int numPoints = 16;
+
+    std::array<float, numPoints> timesteps {};
+    std::array<float, numPoints> frequencies {}; // 0 where no pitch was measured
+    uint32_t generation = 0;
+};
+
+class TimestepPredictor : private AttractorTableWorker<TimestepTable>
+{
+public:
+    TimestepPredictor();
+    ~TimestepPredictor() override;
+
+    /**
+     * Starts the worker for the given sample rate, pitch analysis window size
+     * and timestep range. Not real-time safe.
+     */
+    void prepare(double sampleRate, int analysisWindowSize, float minTimestep, float maxTimestep);
+
+    /** Stops the worker. */
+    void release();
+
+    /**
+     * Picks up the latest table, then hands over the block's parameters and
+     * requests a new table if the attractor changed. Audio thread.
+     */
+    void setAttractor(const ParameterSnapshot& parameters);
+
+    /**
+     * The timestep expected to produce the given frequency with the current
+     * attractor, or 0 if the table for it is not ready yet. Audio thread.
+     */
+    float predictTimestep(float frequency) const;
+
+private:
+    static constexpr int numPoints = TimestepTable::numPoints;
+
+    bool buildTable(TimestepTable& table, const ParameterSnapshot& parameters, uint32_t generation) override;
+    bool isSameAttractor(const ParameterSnapshot& a, const ParameterSnapshot& b) const override;
+    float measureFrequency(const ParameterSnapshot& parameters, float timestep);
+
+    double sampleRate = 44100.0;
+    int analysisWindowSize = 4096;
+    float minTimestep = 0.0001f, maxTimestep = 0.05f;
+
+    // --- Worker state ---
+    LorenzOsc simulator;
+    PoincareEstimator sectionEstimator;
+    std::array<std::unique_ptr<PitchDetector>, 3> detectors; // By PitchDetector::Type
+    std::vector<float> measureBuffer;
+    std::vector<float> windowEstimates;
+    std::array<std::vector<float>, 3> renderBuffers;
+
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR (TimestepPredictor)
+};
@@ -0,0 +1,246 @@
+/*
+  ==============================================================================
+
+    UnisonStack.cpp
+    Created: 16 Oct 2026 10:00:00am
+    Author:  Olivier Doaré
+
+  ==============================================================================
+*/
+
+#include "UnisonStack.h"
+
+namespace
+{
+    // Relative offset on rho and sigma of the outermost copies at full detune
+    constexpr float maxRelativeDetune = 0.02f;
+}
+
+void UnisonStack::prepare(double sampleRate, int newMaxBlockSize, int controlInterval)
+{
+    maxBlockSize = newMaxBlockSize;
+
+    for (auto& bank : banks)
+    {
+        bank.setControlInterval(controlInterval);
+        bank.prepareToPlay(sampleRate);
+    }
+
+    for (auto& osc : oscillators)
+    {
+        osc.setControlInterval(controlInterval);
+        osc.prepareToPlay(sampleRate);
+    }
+
+    for (auto& buffers : copyBuffers)
+        for (auto& buffer : buffers)
+            buffer.assign((size_t) maxBlockSize, 0.0f);
+
+    restart();
+}
+
+void UnisonStack::setNumCopies(int newNumCopies)
+{
+    newNumCopies = juce::jlimit(1, maxCopies, newNumCopies);
+
+    if (newNumCopies == numCopies)
+        return;
+
+    // Copies that join start from their own initial state
+    for (int copy = numCopies - 1; copy < newNumCopies - 1; ++copy)
+        setState(copy, getInitialState(copy));
+
+    for (int copy = 0; copy < maxCopies - 1; ++copy)
+        banks[(size_t) (copy / Bank::numLanes)].setActive(copy % Bank::numLanes, copy < newNumCopies - 1);
+
+    numCopies = newNumCopies;
+    updateLayout();
+}
+
+void UnisonStack::setParameters(const ParameterSnapshot& parameters)
+{
+    for (auto& bank : banks)
+        bank.setParameters(parameters);
+
+    for (auto& osc : oscillators)
+        osc.setParameters(parameters);
+
+    // Only RK4 has a lane version: with the other integrators the copies run
+    // on their own oscillators, so they follow the same scheme as the lead.
+    const bool shouldUseBanks = parameters.integrator == static_cast<int>(LorenzOsc::Integrator::RK4);
+
+    if (shouldUseBanks != useBanks)
+    {
+        useBanks = shouldUseBanks;
+
+        for (int copy = 0; copy < maxCopies - 1; ++copy)
+        {
+            auto& bank = banks[(size_t) (copy / Bank::numLanes)];
+
+            if (useBanks)
+                bank.setState(copy % Bank::numLanes, oscillators[(size_t) copy].getState());
+            else
+                oscillators[(size_t) copy].setState(bank.getState(copy % Bank::numLanes));
+        }
+    }
+
+    if (parameters.unisonDetune != detune || parameters.unisonWidth != width
+        || parameters.rho != baseRho || parameters.sigma != baseSigma)
+    {
+        detune = parameters.unisonDetune;
+        width = parameters.unisonWidth;
+        baseRho = parameters.rho;
+        baseSigma = parameters.sigma;
+        updateLayout();
+    }
+}
+
+void UnisonStack::setModulation(const AttractorOffsets& offsets)
+{
+    modulation = offsets;
+
+    for (auto& bank : banks)
+        bank.setModulation(offsets);
+
+    for (int copy = 0; copy < maxCopies - 1; ++copy)
+        updateOscillatorModulation(copy);
+}
+
+void UnisonStack::setTimestep(float newTimestep)
+{
+    for (int copy = 0; copy < maxCopies - 1; ++copy)
+        banks[(size_t) (copy / Bank::numLanes)].setTimestep(copy % Bank::numLanes, newTimestep);
+
+    for (auto& osc : oscillators)
+        osc.setTimestep(newTimestep);
+}
+
+void UnisonStack::updateParameters()
+{
+    for (auto& bank : banks)
+        bank.updateParameters();
+
+    for (auto& osc : oscillators)
+        osc.updateParameters();
+}
+
+void UnisonStack::restart()
+{
+    for (int copy = 0; copy < maxCopies - 1; ++copy)
+        setState(copy, getInitialState(copy));
+}
+
+void UnisonStack::setState(int copy, const LorenzKernels::State<double>& newState)
+{
+    if (useBanks)
+        banks[(size_t) (copy / Bank::numLanes)].setState(copy % Bank::numLanes, newState);
+    else
+        oscillators[(size_t) copy].setState(newState);
+}
+
+void UnisonStack::updateOscillatorModulation(int copy)
+{
+    AttractorOffsets offsets = modulation;
+    offsets.rho += copyOffsets[(size_t) copy].rho;
+    offsets.sigma += copyOffsets[(size_t) copy].sigma;
+    oscillators[(size_t) copy].setModulation(offsets);
+}
+
+UnisonStack::Bank::State UnisonStack::getInitialState(int copy)
+{
+    // The lead starts from (0.1, 0, 0). Nearby but distinct starts are enough:
+    // the orbits separate within a few cycles and the copies decorrelate.
+    const double k = copy + 1;
+    return { 0.1 + 0.37 * k, (copy % 2 == 0 ? 0.23 : -0.23) * k, 0.0, 0.0, 0.0, 0.0 };
+}
+
+void UnisonStack::updateLayout()
+{
+    const auto gainsAt = [this] (float position) -> std::array<float, 2>
+    {
+        // Constant power, both weights 1 in the centre, scaled down by the number of copies
+        const float angle = (position + 1.0f) * juce::MathConstants<float>::pi * 0.25f;
+        const float gain = juce::MathConstants<float>::sqrt2 / std::sqrt(static_cast<float>(numCopies));
+        return { gain * std::cos(angle), gain * std::sin(angle) };
+    };
+
+    if (numCopies <= 1)
+    {
+        leadGains = { 1.0f, 1.0f };
+        return;
+    }
+
+    // The copies sit evenly across [-1, 1]; the lead takes the middle slot
+    // (left of centre with an even count), the others the remaining slots.
+    const int leadSlot = (numCopies - 1) / 2;
+    const auto slotPosition = [this] (int slot) { return -1.0f + 2.0f * static_cast<float>(slot) / static_cast<float>(numCopies - 1); };
+
+    leadGains = gainsAt(width * slotPosition(leadSlot));
+
+    for (int copy = 0; copy < numCopies - 1; ++copy)
+    {
+        const int slot = copy < leadSlot ? copy : copy + 1;
+        copyGains[(size_t) copy] = gainsAt(width * slotPosition(slot));
+
+        // Detuned by its distance from the lead, up to maxRelativeDetune at the far end
+        const float distance = 0.5f * (slotPosition(slot) - slotPosition(leadSlot));
+        AttractorOffsets offsets;
+        offsets.rho = baseRho * maxRelativeDetune * detune * distance;
+        offsets.sigma = baseSigma * maxRelativeDetune * detune * distance;
+        banks[(size_t) (copy / Bank::numLanes)].setLaneOffsets(copy % Bank::numLanes, offsets);
+        copyOffsets[(size_t) copy] = offsets;
+        updateOscillatorModulation(copy);
+    }
+}
+
+void UnisonStack::render(float* const* leftOut, float* const* rightOut, int numSamples)
+{
+    for (int start = 0; start < numSamples;)
+    {
+        const int length = juce::jmin(numSamples - start, maxBlockSize);
+
+        for (size_t b = 0; useBanks && b < banks.size(); ++b)
+        {
+            const int firstCopy = static_cast<int>(b) * Bank::numLanes;
+            if (firstCopy >= numCopies - 1)
+                break;
+
+            float* xLanes[Bank::numLanes];
+            float* yLanes[Bank::numLanes];
+            float* zLanes[Bank::numLanes];
+
+            for (int l = 0; l < Bank::numLanes; ++l)
+            {
+                auto& buffers = copyBuffers[(size_t) (firstCopy + l)];
+                xLanes[l] = buffers[0].data();
+                yLanes[l] = buffers[1].data();
+                zLanes[l] = buffers[2].data();
+            }
+
+            banks[b].renderBlock(xLanes, yLanes, zLanes, length);
+        }
+
+        for (int copy = 0; ! useBanks && copy < numCopies - 1; ++copy)
+        {
+            auto& buffers = copyBuffers[(size_t) copy];
+            oscillators[(size_t) copy].renderBlock(buffers[0].data(), buffers[1].data(), buffers[2].data(), length);
+        }
+
+        for (int axis = 0; axis < 3; ++axis)
+        {
+            float* left = leftOut[axis] + start;
+            float* right = rightOut[axis] + start;
+            juce::FloatVectorOperations::clear(left, length);
+            juce::FloatVectorOperations::clear(right, length);
+
+            for (int copy = 0; copy < numCopies - 1; ++copy)
+            {
+                const float* samples = copyBuffers[(size_t) copy][(size_t) axis].data();
+                juce::FloatVectorOperations::addWithMultiply(left, samples, copyGains[(size_t) copy][0], length);
+                juce::FloatVectorOperations::addWithMultiply(right, samples, copyGains[(size_t) copy][1], length);
+            }
+        }
+
+        start += length;
+    }
+}
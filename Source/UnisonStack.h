@@ -0,0 +1,100 @@
+/*
+  ==============================================================================
+
+    UnisonStack.h
+    Created: 16 Oct 2026 10:00:00am
+    Author:  Olivier Doaré
+
+  ==============================================================================
+*/
+
+#pragma once
+
+#include <JuceHeader.h>
+#include "LorenzOsc.h"
+#include "LorenzOscBank.h"
+#include "ParameterSnapshot.h"
+
+/**
+ * Extra copies of the monophonic attractor, for the unison mode.
+ *
+ * The processor's own oscillator is the lead copy: it is the one the pitch is
+ * measured on and the PID locks. The other copies run at the lead's timestep,
+ * each from its own initial state and with its own small offsets on rho and
+ * sigma, so they drift apart and beat against the lead instead of doubling it.
+ * With RK4 they run on the lanes of two LorenzOscBanks; the other integrators
+ * have no lane version, so each copy then runs on its own LorenzOsc.
+ *
+ * All the copies, the lead included, are spread evenly across the stereo
+ * field: each has a left and a right weight (constant power, both 1 in the
+ * centre) applied before the mixer's own level and pan. The weights include a
+ * 1 / sqrt(numCopies) gain, so the stack sounds about as loud as one copy.
+ */
+class UnisonStack
+{
+public:
+    static constexpr int maxCopies = 8;
+
+    UnisonStack() = default;
+
+    /** Allocates the copies' scratch buffers. Not real-time safe. */
+    void prepare(double sampleRate, int maxBlockSize, int controlInterval);
+
+    /** Sets the number of copies, the lead included. 1 turns the unison off. New copies start at once. */
+    void setNumCopies(int newNumCopies);
+    int getNumCopies() const { return numCopies; }
+    bool isActive() const { return numCopies > 1; }
+
+    /** Sets the shared attractor parameters, the detune and the stereo width of the copies. */
+    void setParameters(const ParameterSnapshot& parameters);
+
+    void setModulation(const AttractorOffsets& offsets);
+
+    /** Makes the copies follow the lead's timestep. */
+    void setTimestep(float newTimestep);
+
+    /** Snaps the copies' parameters and timestep to their targets, as the lead does on a new note. */
+    void updateParameters();
+
+    /** Puts every copy back to its own initial state. */
+    void restart();
+
+    /** Moves one copy, from 0 to maxCopies - 2 (the lead is not one of them), to the given state. */
+    void setState(int copy, const LorenzKernels::State<double>& newState);
+
+    /** Left and right weights of the lead copy. */
+    float getLeadLeftGain() const { return leadGains[0]; }
+    float getLeadRightGain() const { return leadGains[1]; }
+
+    /**
+     * Renders numSamples of every copy but the lead, and writes their weighted
+     * sums: x, y and z for the left channel, then x, y and z for the right one.
+     */
+    void render(float* const* leftOut, float* const* rightOut, int numSamples);
+
+private:
+    using Bank = LorenzOscBank<4>;
+
+    /** Recomputes the stereo weights and detune offsets of every copy, the lead included. */
+    void updateLayout();
+
+    /** Initial state of a copy, spread around the lead's. */
+    static Bank::State getInitialState(int copy);
+
+    /** Gives a copy's oscillator the shared modulation plus its own detune offsets. */
+    void updateOscillatorModulation(int copy);
+
+    std::array<Bank, (maxCopies - 1 + Bank::numLanes - 1) / Bank::numLanes> banks;
+    std::array<LorenzOsc, maxCopies - 1> oscillators;
+    bool useBanks = true;
+    AttractorOffsets modulation;
+    std::array<AttractorOffsets, maxCopies - 1> copyOffsets {};
+    std::array<std::array<std::vector<float>, 3>, maxCopies - 1> copyBuffers;
+    int maxBlockSize = 0;
+
+    int numCopies = 1;
+    float detune = 0.0f, width = 0.0f;
+    float baseRho = 28.0f, baseSigma = 10.0f;
+    std::array<float, 2> leadGains { 1.0f, 1.0f };
+    std::array<std::array<float, 2>, maxCopies - 1> copyGains {};
+};
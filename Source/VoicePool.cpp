@@ -0,0 +1,557 @@
+/*
+  ==============================================================================
+
+    VoicePool.cpp
+    Created: 16 Oct 2026 10:00:00am
+    Author:  Olivier Doaré
+
+  ==============================================================================
+*/
+
+#include "VoicePool.h"
+
+void LorenzVoice::prepare(double newSampleRate, int maxBlockSize, int controlInterval)
+{
+    sampleRate = newSampleRate;
+
+    osc.setControlInterval(controlInterval);
+    osc.prepareToPlay(sampleRate);
+    envelope.setSampleRate(sampleRate);
+    sectionEstimator.prepare(sampleRate);
+    pidController.setIntegralLimits(-0.001f, 0.001f);
+
+    xBuffer.assign((size_t) maxBlockSize, 0.0f);
+    yBuffer.assign((size_t) maxBlockSize, 0.0f);
+    zBuffer.assign((size_t) maxBlockSize, 0.0f);
+
+    reset();
+}
+
+void LorenzVoice::reset()
+{
+    envelope.reset();
+    note = -1;
+    released = true;
+    targetFrequency = 0.0f;
+}
+
+void LorenzVoice::start(int newNote, float frequency, float newTimestep, uint32_t order,
+                        const LorenzKernels::State<double>& startState)
+{
+    const float previousTimestep = timestep;
+
+    note = newNote;
+    released = false;
+    startOrder = order;
+    targetFrequency = frequency;
+    timestep = newTimestep;
+
+    setTimestep(timestep);
+
+    if (isActive())
+    {
+        // Still sounding: keep the attractor and what was learnt about it
+        frequencyTracker.scaleFrequency(timestep / previousTimestep);
+        pidController.reset();
+    }
+    else
+    {
+        // Both resets snap the timestep, so the note starts right at its pitch
+        osc.reset();
+        osc.setState(startState);
+        bank->resetLane(lane);
+        bank->setState(lane, startState);
+        pidController.reset();
+        sectionEstimator.reset();
+        frequencyTracker.reset();
+        sensitivityEstimator.reset();
+        lastSectionFrequency = 0.0f;
+        timestepHistory.fill(0.0f);
+        timestepHistoryIndex = 0;
+    }
+
+    envelope.noteOn();
+}
+
+void LorenzVoice::setParameters(const ParameterSnapshot& parameters, const juce::ADSR::Parameters& envelopeParameters)
+{
+    ParameterSnapshot voiceParameters = parameters;
+    voiceParameters.timestep = timestep;
+    osc.setParameters(voiceParameters);
+
+    envelope.setParameters(envelopeParameters);
+}
+
+void LorenzVoice::setSection(int axis, float level, float hysteresis)
+{
+    if (axis != sectionAxis)
+    {
+        sectionAxis = axis;
+        sectionEstimator.reset();
+        frequencyTracker.reset();
+        sensitivityEstimator.reset();
+    }
+
+    sectionEstimator.setSection(level, hysteresis);
+}
+
+void LorenzVoice::setTimestep(float newTimestep)
+{
+    osc.setTimestep(newTimestep);
+    bank->setTimestep(lane, newTimestep);
+}
+
+void LorenzVoice::setUseBank(bool shouldUseBank)
+{
+    if (shouldUseBank == usingBank)
+        return;
+
+    usingBank = shouldUseBank;
+
+    if (usingBank)
+        bank->setState(lane, osc.getState());
+    else
+        osc.setState(bank->getState(lane));
+}
+
+void LorenzVoice::renderOscillator(int startSample, int numSamples)
+{
+    osc.renderBlock(xBuffer.data() + startSample, yBuffer.data() + startSample, zBuffer.data() + startSample, numSamples);
+}
+
+void LorenzVoice::processOutput(int startSample, int numSamples)
+{
+    for (int i = startSample; i < startSample + numSamples; ++i)
+    {
+        float x = xBuffer[(size_t) i];
+        float y = yBuffer[(size_t) i];
+        float z = zBuffer[(size_t) i];
+
+        // An unstable voice must not corrupt the sum of the others
+        if (! std::isfinite(x)) x = 0.0f;
+        if (! std::isfinite(y)) y = 0.0f;
+        if (! std::isfinite(z)) z = 0.0f;
+
+        sectionEstimator.pushSample(sectionAxis == 0 ? x : (sectionAxis == 1 ? y : z));
+
+        const float gain = envelope.getNextSample();
+        xBuffer[(size_t) i] = x * gain;
+        yBuffer[(size_t) i] = y * gain;
+        zBuffer[(size_t) i] = z * gain;
+    }
+}
+
+void LorenzVoice::addTo(float* xOut, float* yOut, float* zOut, int numSamples) const
+{
+    juce::FloatVectorOperations::add(xOut, xBuffer.data(), numSamples);
+    juce::FloatVectorOperations::add(yOut, yBuffer.data(), numSamples);
+    juce::FloatVectorOperations::add(zOut, zBuffer.data(), numSamples);
+}
+
+float LorenzVoice::getPastTimestep(int numUpdates) const
+{
+    const int size = static_cast<int>(timestepHistory.size());
+    const int index = (timestepHistoryIndex - 1 - juce::jlimit(0, size - 1, numUpdates) + size) % size;
+    const float pastTimestep = timestepHistory[(size_t) index];
+
+    // Before the history has filled, the oldest known timestep is the current one
+    return pastTimestep > 0.0f ? pastTimestep : timestep;
+}
+
+void LorenzVoice::updatePitchControl(float intervalSeconds, const ParameterSnapshot& parameters,
+                                     const juce::NormalisableRange<float>& timestepRange)
+{
+    // The timestep the voice ran with over the interval just ended
+    timestepHistory[(size_t) timestepHistoryIndex] = timestep;
+    timestepHistoryIndex = (timestepHistoryIndex + 1) % static_cast<int>(timestepHistory.size());
+
+    frequencyTracker.predict(intervalSeconds);
+
+    // The section estimate changes at each crossing; an unchanged value is not
+    // a new measurement. As in the processor, it describes the signal the
+    // estimator's latency ago: it is paired with the timestep of then to learn
+    // the sensitivity, and given to the tracker as it would be at the current one.
+    if (const float frequency = sectionEstimator.getFrequency(); frequency != lastSectionFrequency)
+    {
+        lastSectionFrequency = frequency;
+
+        const auto ageSeconds = static_cast<float>(sectionEstimator.getLatencySamples() / sampleRate);
+        const float pastTimestep = getPastTimestep(juce::roundToInt(ageSeconds / intervalSeconds));
+
+        if (frequencyTracker.addMeasurement(frequency * timestep / pastTimestep, 1.0f, ageSeconds))
+            sensitivityEstimator.addObservation(pastTimestep, frequency);
+    }
+
+    const float measured = frequencyTracker.getFrequency();
+    if (measured <= 0.0f || targetFrequency <= 0.0f)
+        return;
+
+    const float gainScale = parameters.gainScheduling ? sensitivityEstimator.getGainScale() : 1.0f;
+    pidController.setGains(parameters.kp * gainScale, parameters.ki * gainScale, parameters.kd * gainScale);
+
+    const float previousTimestep = timestep;
+    timestep = timestepRange.snapToLegalValue(timestep + pidController.process(targetFrequency, measured, intervalSeconds));
+
+    setTimestep(timestep);
+    frequencyTracker.scaleFrequency(timestep / previousTimestep);
+}
+
+//==============================================================================
+void VoicePool::prepare(double newSampleRate, int newMaxBlockSize, int controlInterval)
+{
+    sampleRate = newSampleRate;
+    maxBlockSize = newMaxBlockSize;
+    stepLength = controlInterval;
+
+    for (auto& bank : banks)
+    {
+        bank.setControlInterval(controlInterval);
+        bank.prepareToPlay(sampleRate);
+    }
+
+    for (size_t i = 0; i < voices.size(); ++i)
+    {
+        voices[i].attachToBank(banks[i / VoiceBank::numLanes], static_cast<int>(i % VoiceBank::numLanes));
+        voices[i].prepare(sampleRate, maxBlockSize, controlInterval);
+    }
+
+    // At most one modulation update per control tick, and one pitch-lock update per sample
+    modulationEvents.reserve((size_t) (maxBlockSize / controlInterval + 2));
+    pitchControlEvents.reserve((size_t) (maxBlockSize + 1));
+
+    // The audio thread renders too, so one core is left to it
+    workers.prepare(juce::jlimit(0, maxWorkers, juce::SystemStats::getNumCpus() - 1), sampleRate, maxBlockSize);
+}
+
+void VoicePool::release()
+{
+    workers.release();
+}
+
+void VoicePool::reset()
+{
+    for (auto& voice : voices)
+        voice.reset();
+}
+
+void VoicePool::setNumVoices(int newNumVoices)
+{
+    numVoices = juce::jlimit(1, maxVoices, newNumVoices);
+
+    for (int i = numVoices; i < maxVoices; ++i)
+        voices[(size_t) i].reset();
+}
+
+LorenzVoice* VoicePool::findVoiceFor(int note)
+{
+    LorenzVoice* idle = nullptr;
+    LorenzVoice* oldestReleased = nullptr;
+    LorenzVoice* oldest = nullptr;
+
+    for (int i = 0; i < numVoices; ++i)
+    {
+        auto& voice = voices[(size_t) i];
+
+        // A repeated note retriggers its own voice
+        if (voice.isActive() && voice.getNote() == note && ! voice.isReleased())
+            return &voice;
+
+        if (! voice.isActive())
+        {
+            if (idle == nullptr)
+                idle = &voice;
+        }
+        else if (voice.isReleased())
+        {
+            if (oldestReleased == nullptr || voice.getStartOrder() - oldestReleased->getStartOrder() > 0x80000000u)
+                oldestReleased = &voice;
+        }
+        else if (oldest == nullptr || voice.getStartOrder() - oldest->getStartOrder() > 0x80000000u)
+        {
+            oldest = &voice;
+        }
+    }
+
+    if (idle != nullptr)
+        return idle;
+
+    return oldestReleased != nullptr ? oldestReleased : oldest;
+}
+
+void VoicePool::noteOn(int note, float frequency, float timestep, const LorenzKernels::State<double>& startState)
+{
+    if (auto* voice = findVoiceFor(note))
+    {
+        // An idle bank has not followed the parameters; it catches up at once
+        const auto bankIndex = static_cast<size_t>((voice - voices.data()) / VoiceBank::numLanes);
+        bool bankIdle = true;
+
+        for (int l = 0; l < VoiceBank::numLanes; ++l)
+            bankIdle = bankIdle && ! voices[bankIndex * VoiceBank::numLanes + (size_t) l].isActive();
+
+        voice->setParameters(parameters, envelopeParameters);
+        voice->setSection(sectionAxis, sectionLevel, sectionHysteresis);
+        voice->setModulation(modulation);
+        voice->start(note, frequency, timestep, nextStartOrder++, startState);
+
+        if (bankIdle)
+            banks[bankIndex].updateParameters();
+    }
+}
+
+void VoicePool::noteOff(int note)
+{
+    for (int i = 0; i < numVoices; ++i)
+    {
+        auto& voice = voices[(size_t) i];
+        if (voice.getNote() == note && ! voice.isReleased())
+            voice.stop();
+    }
+}
+
+void VoicePool::setParameters(const ParameterSnapshot& newParameters, const juce::ADSR::Parameters& newEnvelopeParameters)
+{
+    parameters = newParameters;
+    envelopeParameters = newEnvelopeParameters;
+
+    // Only RK4 has a lane version
+    useBanks = parameters.integrator == static_cast<int>(LorenzOsc::Integrator::RK4);
+
+    for (auto& bank : banks)
+        bank.setParameters(parameters);
+
+    for (int i = 0; i < numVoices; ++i)
+    {
+        voices[(size_t) i].setParameters(parameters, envelopeParameters);
+        voices[(size_t) i].setUseBank(useBanks);
+    }
+}
+
+void VoicePool::setSection(int axis, float level, float hysteresis)
+{
+    sectionAxis = axis;
+    sectionLevel = level;
+    sectionHysteresis = hysteresis;
+
+    for (int i = 0; i < numVoices; ++i)
+        voices[(size_t) i].setSection(axis, level, hysteresis);
+}
+
+void VoicePool::setModulation(const AttractorOffsets& offsets)
+{
+    modulation = offsets;
+
+    for (auto& bank : banks)
+        bank.setModulation(offsets);
+
+    for (int i = 0; i < numVoices; ++i)
+        if (voices[(size_t) i].isActive())
+            voices[(size_t) i].setModulation(offsets);
+}
+
+void VoicePool::scheduleModulation(int sample, const AttractorOffsets& offsets)
+{
+    // Never reallocates: render() spans are bounded by getMaxSpanLength()
+    jassert(modulationEvents.size() < modulationEvents.capacity());
+    if (modulationEvents.size() < modulationEvents.capacity())
+        modulationEvents.emplace_back(sample, offsets);
+}
+
+void VoicePool::schedulePitchControl(int sample, float intervalSeconds, const juce::NormalisableRange<float>& range)
+{
+    jassert(pitchControlEvents.size() < pitchControlEvents.capacity());
+    if (pitchControlEvents.size() < pitchControlEvents.capacity())
+        pitchControlEvents.push_back(sample);
+
+    pitchControlInterval = intervalSeconds;
+    timestepRange = &range;
+}
+
+void VoicePool::render(float* xOut, float* yOut, float* zOut, int numSamples)
+{
+    std::fill(xOut, xOut + numSamples, 0.0f);
+    std::fill(yOut, yOut + numSamples, 0.0f);
+    std::fill(zOut, zOut + numSamples, 0.0f);
+
+    firstModulationEvent = 0;
+    firstPitchControlEvent = 0;
+
+    // The voices render into their own scratch buffers, so long blocks go in chunks of their size
+    for (int start = 0; start < numSamples;)
+    {
+        chunkStart = start;
+        chunkLength = juce::jmin(numSamples - start, maxBlockSize);
+
+        while (firstModulationEvent < modulationEvents.size() && modulationEvents[firstModulationEvent].first < chunkStart)
+            ++firstModulationEvent;
+
+        while (firstPitchControlEvent < pitchControlEvents.size() && pitchControlEvents[firstPitchControlEvent] < chunkStart)
+            ++firstPitchControlEvent;
+
+        for (int i = 0; i < maxVoices; ++i)
+            voiceRendered[(size_t) i] = i < numVoices && voices[(size_t) i].isActive();
+
+        // One job per bank with a sounding voice, or per sounding voice
+        int numJobs = 0;
+
+        if (useBanks)
+        {
+            for (int b = 0; b < static_cast<int>(banks.size()); ++b)
+                for (int l = 0; l < VoiceBank::numLanes; ++l)
+                    if (voiceRendered[(size_t) (b * VoiceBank::numLanes + l)])
+                    {
+                        jobTargets[(size_t) numJobs++] = b;
+                        break;
+                    }
+        }
+        else
+        {
+            for (int i = 0; i < maxVoices; ++i)
+                if (voiceRendered[(size_t) i])
+                    jobTargets[(size_t) numJobs++] = i;
+        }
+
+        // Workers that have not started a job or a step within half the chunk's
+        // duration leave the rest to this thread
+        workers.run(*this, numJobs, 0.5 * chunkLength / sampleRate);
+
+        // Single summing stage, on the audio thread
+        for (int i = 0; i < maxVoices; ++i)
+            if (voiceRendered[(size_t) i])
+                voices[(size_t) i].addTo(xOut + start, yOut + start, zOut + start, chunkLength);
+
+        start += chunkLength;
+    }
+
+    // The banks that did not render (all of them without the banks) did not run
+    // the updates; they catch up with the latest offsets, which also go to the
+    // voices that start next.
+    if (! modulationEvents.empty())
+    {
+        modulation = modulationEvents.back().second;
+
+        for (size_t b = 0; b < banks.size(); ++b)
+        {
+            bool bankRendered = false;
+            for (int l = 0; l < VoiceBank::numLanes; ++l)
+                bankRendered = bankRendered || voiceRendered[b * VoiceBank::numLanes + (size_t) l];
+
+            if (! useBanks || ! bankRendered)
+                banks[b].setModulation(modulation);
+        }
+    }
+
+    modulationEvents.clear();
+    pitchControlEvents.clear();
+}
+
+int VoicePool::getNumSteps(int) const
+{
+    return (chunkLength + stepLength - 1) / stepLength;
+}
+
+void VoicePool::runJobStep(int index, int step)
+{
+    const int target = jobTargets[(size_t) index];
+
+    if (useBanks && step == 0)
+        for (int l = 0; l < VoiceBank::numLanes; ++l)
+            banks[(size_t) target].setActive(l, voiceRendered[(size_t) (target * VoiceBank::numLanes + l)]);
+
+    const int stepStart = chunkStart + step * stepLength;
+    const int stepEnd = juce::jmin(stepStart + stepLength, chunkStart + chunkLength);
+
+    // The updates before the step were run by the previous steps
+    size_t nextModulation = firstModulationEvent;
+    while (nextModulation < modulationEvents.size() && modulationEvents[nextModulation].first < stepStart)
+        ++nextModulation;
+
+    size_t nextPitchControl = firstPitchControlEvent;
+    while (nextPitchControl < pitchControlEvents.size() && pitchControlEvents[nextPitchControl] < stepStart)
+        ++nextPitchControl;
+
+    // Render up to each scheduled update, then run it, in the order the processor
+    // schedules them: the modulation first, then the pitch lock.
+    for (int position = stepStart; position < stepEnd;)
+    {
+        for (; nextModulation < modulationEvents.size() && modulationEvents[nextModulation].first <= position; ++nextModulation)
+            applyModulation(target, modulationEvents[nextModulation].second);
+
+        for (; nextPitchControl < pitchControlEvents.size() && pitchControlEvents[nextPitchControl] <= position; ++nextPitchControl)
+            updatePitchControl(target);
+
+        int end = stepEnd;
+        if (nextModulation < modulationEvents.size())
+            end = juce::jmin(end, modulationEvents[nextModulation].first);
+        if (nextPitchControl < pitchControlEvents.size())
+            end = juce::jmin(end, pitchControlEvents[nextPitchControl]);
+
+        renderJobTarget(target, position - chunkStart, end - position);
+        position = end;
+    }
+}
+
+void VoicePool::renderJobTarget(int target, int startSample, int numSamples)
+{
+    if (! useBanks)
+    {
+        voices[(size_t) target].renderOscillator(startSample, numSamples);
+        voices[(size_t) target].processOutput(startSample, numSamples);
+        return;
+    }
+
+    // The bank steps its four voices together; idle lanes are masked out
+    auto& bank = banks[(size_t) target];
+    float* xLanes[VoiceBank::numLanes];
+    float* yLanes[VoiceBank::numLanes];
+    float* zLanes[VoiceBank::numLanes];
+
+    for (int l = 0; l < VoiceBank::numLanes; ++l)
+    {
+        auto& voice = voices[(size_t) (target * VoiceBank::numLanes + l)];
+        xLanes[l] = voice.getXBuffer() + startSample;
+        yLanes[l] = voice.getYBuffer() + startSample;
+        zLanes[l] = voice.getZBuffer() + startSample;
+    }
+
+    bank.renderBlock(xLanes, yLanes, zLanes, numSamples);
+
+    for (int l = 0; l < VoiceBank::numLanes; ++l)
+        if (bank.isActive(l))
+            voices[(size_t) (target * VoiceBank::numLanes + l)].processOutput(startSample, numSamples);
+}
+
+void VoicePool::applyModulation(int target, const AttractorOffsets& offsets)
+{
+    if (! useBanks)
+    {
+        voices[(size_t) target].setModulation(offsets);
+        return;
+    }
+
+    banks[(size_t) target].setModulation(offsets);
+
+    // The voices' own oscillators follow too, for a switch of integrator
+    for (int l = 0; l < VoiceBank::numLanes; ++l)
+        voices[(size_t) (target * VoiceBank::numLanes + l)].setModulation(offsets);
+}
+
+void VoicePool::updatePitchControl(int target)
+{
+    // Each sounding voice runs its own lock on its own note
+    const int first = useBanks ? target * VoiceBank::numLanes : target;
+    const int last = useBanks ? first + VoiceBank::numLanes : first + 1;
+
+    for (int i = first; i < last; ++i)
+        if (voiceRendered[(size_t) i])
+            voices[(size_t) i].updatePitchControl(pitchControlInterval, parameters, *timestepRange);
+}
+
+bool VoicePool::isAnyVoiceActive() const
+{
+    for (int i = 0; i < numVoices; ++i)
+        if (voices[(size_t) i].isActive())
+            return true;
+
+    return false;
+}
@@ -0,0 +1,255 @@
+/*
+  ==============================================================================
+
+    VoicePool.h
+    Created: 16 Oct 2026 10:00:00am
+    Author:  Olivier Doaré
+
+  ==============================================================================
+*/
+
+#pragma once
+
+#include <JuceHeader.h>
+#include "LorenzOsc.h"
+#include "LorenzOscBank.h"
+#include "ParameterSnapshot.h"
+#include "PIDController.h"
+#include "PoincareEstimator.h"
+#include "FrequencyTracker.h"
+#include "SensitivityEstimator.h"
+#include "RenderWorkerPool.h"
+
+/** The voices are integrated four at a time, one per lane of a bank. */
+using VoiceBank = LorenzOscBank<4>;
+
+/**
+ * One note of the polyphonic mode: an attractor with its own state, amplitude
+ * envelope and pitch lock.
+ *
+ * Each voice measures its own period through a Poincaré section of its raw
+ * state, which costs a few operations per sample, so there is no per-voice
+ * analysis window or worker. The estimates go through a FrequencyTracker into
+ * a PIDController, as in the monophonic mode.
+ *
+ * With the RK4 integrator the attractor runs on a lane of a VoiceBank, shared
+ * with three other voices. The other integrators have no lane version, so the
+ * voice then runs its own LorenzOsc; the state is carried over on a switch.
+ */
+class LorenzVoice
+{
+public:
+    LorenzVoice() = default;
+
+    /** Allocates the scratch buffers. Not real-time safe. */
+    void prepare(double sampleRate, int maxBlockSize, int controlInterval);
+
+    /** Gives the voice its lane. The bank is prepared and rendered by the pool. */
+    void attachToBank(VoiceBank& newBank, int newLane) { bank = &newBank; lane = newLane; }
+    int getLane() const { return lane; }
+
+    /** Silences the voice at once and forgets its note. */
+    void reset();
+
+    /**
+     * Plays a note at the given timestep. An idle voice restarts its attractor
+     * from startState; a voice that still sounds (a stolen or retriggered one)
+     * keeps its state and glides to the new timestep, so it does not click.
+     */
+    void start(int newNote, float frequency, float newTimestep, uint32_t order,
+               const LorenzKernels::State<double>& startState);
+
+    /** Enters the release stage. */
+    void stop() { envelope.noteOff(); released = true; }
+
+    bool isActive() const { return envelope.isActive(); }
+    bool isReleased() const { return released; }
+    int getNote() const { return note; }
+    uint32_t getStartOrder() const { return startOrder; }
+
+    /** Sets the block's parameters. The timestep is the voice's own, not the snapshot's. */
+    void setParameters(const ParameterSnapshot& parameters, const juce::ADSR::Parameters& envelopeParameters);
+
+    /** Selects the coordinate (0, 1, 2: x, y, z) and the level of the section the pitch is measured on. */
+    void setSection(int axis, float level, float hysteresis);
+
+    void setModulation(const AttractorOffsets& offsets) { osc.setModulation(offsets); }
+
+    /** Selects the bank lane (true) or the voice's own oscillator (false), carrying the state over. */
+    void setUseBank(bool shouldUseBank);
+
+    /** Renders numSamples with the voice's own oscillator into its scratch buffers, from startSample on. */
+    void renderOscillator(int startSample, int numSamples);
+
+    /** Scratch buffers the voice's raw x, y and z are rendered into, by the oscillator or the bank. */
+    float* getXBuffer() { return xBuffer.data(); }
+    float* getYBuffer() { return yBuffer.data(); }
+    float* getZBuffer() { return zBuffer.data(); }
+
+    /**
+     * Applies the envelope to the numSamples just rendered from startSample on,
+     * in place, and measures their pitch. Runs on the thread that rendered them.
+     */
+    void processOutput(int startSample, int numSamples);
+
+    /** Adds the processed x, y and z to the outputs. */
+    void addTo(float* xOut, float* yOut, float* zOut, int numSamples) const;
+
+    /** Runs one update of the voice's pitch lock. */
+    void updatePitchControl(float intervalSeconds, const ParameterSnapshot& parameters,
+                            const juce::NormalisableRange<float>& timestepRange);
+
+private:
+    /** Sets the timestep of both the oscillator and the lane, so either can take over. */
+    void setTimestep(float newTimestep);
+
+    /** Timestep that was in use numUpdates pitch-lock updates ago. */
+    float getPastTimestep(int numUpdates) const;
+
+    LorenzOsc osc;
+    VoiceBank* bank = nullptr;
+    int lane = 0;
+    bool usingBank = false;
+
+    juce::ADSR envelope;
+    PIDController pidController;
+    PoincareEstimator sectionEstimator;
+    FrequencyTracker frequencyTracker;
+    SensitivityEstimator sensitivityEstimator;
+
+    // As in the processor, the timesteps of the last updates, to pair each
+    // section estimate with the timestep it measured
+    std::array<float, 32> timestepHistory {};
+    int timestepHistoryIndex = 0;
+
+    std::vector<float> xBuffer, yBuffer, zBuffer;
+    double sampleRate = 44100.0;
+
+    int note = -1;
+    bool released = true;
+    uint32_t startOrder = 0;
+    float targetFrequency = 0.0f;
+    float timestep = 0.001f;
+    float lastSectionFrequency = 0.0f;
+    int sectionAxis = 0; // 0, 1, 2: x, y, z
+
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR (LorenzVoice)
+};
+
+//==============================================================================
+/**
+ * A fixed pool of LorenzVoices for the polyphonic mode.
+ *
+ * All voices are allocated by prepare(); playing, stealing and rendering never
+ * allocate. A note goes to an idle voice if there is one, otherwise it steals
+ * the oldest released voice, otherwise the oldest voice. The voices are summed
+ * before the mixer, so level, pan and output gains are applied once for all.
+ *
+ * The banks (or the voices, with the integrators that have no lane version)
+ * are rendered as independent jobs, shared between the audio thread and a
+ * RenderWorkerPool. The audio thread then sums the voices on its own.
+ *
+ * A render covers a whole span between two MIDI events, so the workers get
+ * one batch per span rather than one per control tick. The modulation and
+ * pitch-lock updates that fall inside the span are scheduled beforehand, and
+ * each job runs them for its own voices on their exact sample. A job is split
+ * into steps of one control interval, so that the audio thread can take over
+ * a job a worker is late with.
+ */
+class VoicePool : private RenderWorkerPool::JobList
+{
+public:
+    static constexpr int maxVoices = 16;
+    static constexpr int maxWorkers = 3;
+
+    VoicePool() = default;
+
+    /** Prepares every voice of the pool and starts the render workers. Not real-time safe. */
+    void prepare(double sampleRate, int maxBlockSize, int controlInterval);
+
+    /** Stops the render workers. */
+    void release();
+
+    /** Silences every voice. */
+    void reset();
+
+    /** Limits the number of voices played from the next note on. Voices beyond it are silenced. */
+    void setNumVoices(int newNumVoices);
+
+    /** Starts a note at the given timestep, stealing a voice if needed. An idle voice starts from startState. */
+    void noteOn(int note, float frequency, float timestep, const LorenzKernels::State<double>& startState);
+
+    /** Releases the voice playing the note, if any. */
+    void noteOff(int note);
+
+    /** Sets the block's parameters on every voice. */
+    void setParameters(const ParameterSnapshot& newParameters, const juce::ADSR::Parameters& newEnvelopeParameters);
+
+    /** Sets the section every voice measures its pitch on. */
+    void setSection(int axis, float level, float hysteresis);
+
+    /** Sets the modulation offsets of every voice at once. */
+    void setModulation(const AttractorOffsets& offsets);
+
+    /** Queues new modulation offsets at the given sample of the next render(). Samples must not decrease. */
+    void scheduleModulation(int sample, const AttractorOffsets& offsets);
+
+    /** Queues a pitch-lock update of every sounding voice at the given sample of the next render(). */
+    void schedulePitchControl(int sample, float intervalSeconds, const juce::NormalisableRange<float>& timestepRange);
+
+    /** Longest span render() can take with room for all its scheduled updates. */
+    int getMaxSpanLength() const { return maxBlockSize; }
+
+    /**
+     * Writes the sum of the active voices' x, y and z, weighted by their
+     * envelopes, running the scheduled updates on their sample. numSamples is
+     * at most getMaxSpanLength().
+     */
+    void render(float* xOut, float* yOut, float* zOut, int numSamples);
+
+    bool isAnyVoiceActive() const;
+
+private:
+    LorenzVoice* findVoiceFor(int note);
+
+    int getNumSteps(int index) const override;
+
+    /** Renders one step of a bank, or of a voice, and processes the voices' output, with the updates due in the step. */
+    void runJobStep(int index, int step) override;
+
+    /** Renders numSamples of one job's bank or voice from startSample of the chunk on. */
+    void renderJobTarget(int target, int startSample, int numSamples);
+    void applyModulation(int target, const AttractorOffsets& offsets);
+    void updatePitchControl(int target);
+
+    std::array<LorenzVoice, maxVoices> voices;
+    std::array<VoiceBank, maxVoices / VoiceBank::numLanes> banks;
+    bool useBanks = true;
+    int numVoices = maxVoices;
+    uint32_t nextStartOrder = 0;
+    int maxBlockSize = 0;
+    int stepLength = 32; // Samples per job step: one control interval
+    double sampleRate = 44100.0;
+
+    // The jobs of the current chunk: bank indices, or voice indices without the banks
+    RenderWorkerPool workers;
+    std::array<int, maxVoices> jobTargets {};
+    std::array<bool, maxVoices> voiceRendered {};
+    int chunkStart = 0;
+    int chunkLength = 0;
+
+    // Updates scheduled for the next render, in sample order. Read-only while the jobs run.
+    std::vector<std::pair<int, AttractorOffsets>> modulationEvents;
+    std::vector<int> pitchControlEvents;
+    size_t firstModulationEvent = 0, firstPitchControlEvent = 0; // Of the current chunk
+    float pitchControlInterval = 0.0f;
+    const juce::NormalisableRange<float>* timestepRange = nullptr;
+
+    // Latest block settings, also handed to voices that start within the block
+    ParameterSnapshot parameters;
+    juce::ADSR::Parameters envelopeParameters;
+    AttractorOffsets modulation;
+    int sectionAxis = 0;
+    float sectionLevel = 0.0f;
+    float sectionHysteresis = 0.0f;
+};
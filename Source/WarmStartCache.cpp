@@ -0,0 +1,116 @@
+/*
+  ==============================================================================
+
+    WarmStartCache.cpp
+    Created: 16 Oct 2026 10:00:00am
+    Author:  Olivier Doaré
+
+  ==============================================================================
+*/
+
+#include "WarmStartCache.h"
+
+namespace
+{
+    // Simulation time per sample of the offline run: the largest step the
+    // oscillator takes without sub-stepping.
+    constexpr float simulationTimestep = LorenzKernels::maxSimulationTimestep;
+
+    // Simulation time discarded as the transient, then between two snapshots.
+    // The spacing is well below one turn of the orbit and not a multiple of it.
+    constexpr double settleTime = 50.0;
+    constexpr double snapshotInterval = 0.37;
+
+    // Beyond this the orbit is not on a bounded attractor. The oscillator resets
+    // itself when it overflows, so a diverging orbit also shows up as huge but
+    // finite states.
+    constexpr double maxCoordinate = 1.0e3;
+}
+
+WarmStartCache::WarmStartCache()
+    : AttractorTableWorker("Warm Start Cache")
+{
+}
+
+WarmStartCache::~WarmStartCache()
+{
+    release();
+}
+
+void WarmStartCache::prepare(double sampleRate)
+{
+    release();
+
+    simulator.prepareToPlay(sampleRate);
+    for (auto& buffer : renderBuffers)
+        buffer.assign((size_t) (snapshotInterval / simulationTimestep) + 1, 0.0f);
+
+    startWorker();
+}
+
+void WarmStartCache::release()
+{
+    stopWorker();
+}
+
+void WarmStartCache::setAttractor(const ParameterSnapshot& parameters)
+{
+    requestTable(parameters);
+}
+
+bool WarmStartCache::isReady() const
+{
+    return isTableCurrent();
+}
+
+WarmStartCache::State WarmStartCache::getState(int phase) const
+{
+    return getTable().states[(size_t) (((phase % numStates) + numStates) % numStates)];
+}
+
+WarmStartCache::State WarmStartCache::getRandomState()
+{
+    return getState(random.nextInt(numStates));
+}
+
+bool WarmStartCache::buildTable(WarmStartTable& table, const ParameterSnapshot& parameters, uint32_t generation)
+{
+    ParameterSnapshot simulated = parameters;
+    simulated.timestep = simulationTimestep;
+    simulator.setParameters(simulated);
+    simulator.reset(); // Also snaps the parameters to their targets
+
+    const int chunk = static_cast<int>(renderBuffers[0].size());
+    const int settleSamples = static_cast<int>(settleTime / simulationTimestep);
+    const int intervalSamples = static_cast<int>(snapshotInterval / simulationTimestep);
+
+    const auto render = [this, chunk] (int numSamples)
+    {
+        for (int rendered = 0; rendered < numSamples; rendered += chunk)
+            simulator.renderBlock(renderBuffers[0].data(), renderBuffers[1].data(), renderBuffers[2].data(),
+                                  juce::jmin(chunk, numSamples - rendered));
+    };
+
+    render(settleSamples);
+    table.valid = true;
+
+    for (int i = 0; i < numStates; ++i)
+    {
+        // Give up as soon as the request is superseded
+        if (isSuperseded(generation))
+            return false;
+
+        render(intervalSamples);
+        const State state = simulator.getState();
+
+        for (size_t j = 0; j < 3; ++j)
+            table.valid = table.valid && std::abs(state[j]) < maxCoordinate; // Also false for NaN
+
+        table.states[(size_t) i] = state;
+
+        if (! table.valid)
+            break;
+    }
+
+    return true;
+}
@@ -0,0 +1,88 @@
+/*
+  ==============================================================================
+
+    WarmStartCache.h
+    Created: 16 Oct 2026 10:00:00am
+    Author:  Olivier Doaré
+
+  ==============================================================================
+*/
+
+#pragma once
+
+#include <JuceHeader.h>
+#include "LorenzOsc.h"
+#include "AttractorTableWorker.h"
+
+/**
+ * States already on the attractor, so a note can start in its steady timbre
+ * instead of replaying the start-up transient from the initial state.
+ *
+ * For the current attractor parameters, a background thread integrates past
+ * the transient, then records a snapshot of the state at regular intervals of
+ * simulation time. The interval is not a multiple of the period, so the
+ * snapshots are spread over the phases of the orbit. The states do not depend
+ * on the timestep: it only sets how fast the orbit is played.
+ *
+ * As with the TimestepPredictor, the snapshots are taken again by an
+ * AttractorTableWorker when a parameter that changes the attractor's shape
+ * (sigma, rho, beta, masses, damping, taming, integrator) changes. Until they
+ * are ready, notes start from the initial state, and they stay there if the
+ * orbit diverges.
+ */
+struct WarmStartTable
+{
+    static constexpr int numStates = 64;
+
+    std::array<LorenzKernels::State<double>, numStates> states {};
+    bool valid = false; // False when the attractor diverged. Such tables are not published.
+    uint32_t generation = 0;
+};
+
+class WarmStartCache : private AttractorTableWorker<WarmStartTable>
+{
+public:
+    using State = LorenzKernels::State<double>;
+
+    static constexpr int numStates = WarmStartTable::numStates;
+
+    WarmStartCache();
+    ~WarmStartCache() override;
+
+    /** Starts the worker. Not real-time safe. */
+    void prepare(double sampleRate);
+
+    /** Stops the worker. */
+    void release();
+
+    /**
+     * Picks up the latest snapshots, then hands over the block's parameters and
+     * requests new snapshots if the attractor changed. Audio thread.
+     */
+    void setAttractor(const ParameterSnapshot& parameters);
+
+    /** True once the snapshots for the current attractor are ready. Audio thread. */
+    bool isReady() const;
+
+    /** One of the snapshots, by phase index (wrapped to numStates). Only valid when isReady(). Audio thread. */
+    State getState(int phase) const;
+
+    /** A snapshot picked at random. Only valid when isReady(). Audio thread. */
+    State getRandomState();
+
+private:
+    bool buildTable(WarmStartTable& table, const ParameterSnapshot& parameters, uint32_t generation) override;
+
+    // A diverging orbit gives nothing to start from: notes keep starting
+    // from the initial state until the attractor changes again.
+    bool shouldPublish(const WarmStartTable& table) const override { return table.valid; }
+
+    // --- Audio thread state ---
+    juce::Random random;
+
+    // --- Worker state ---
+    LorenzOsc simulator;
+    std::array<std::vector<float>, 3> renderBuffers;
+
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR (WarmStartCache)
+};